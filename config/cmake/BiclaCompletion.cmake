@@ -0,0 +1,55 @@
+# -------------------------------------------------------------------------
+# bicla_add_completion(<target>
+#                      PROGRAM <name>
+#                      SOURCES <source>...
+#                      [DESTINATION <directory>])
+#
+# Builds a completion generator from SOURCES, whose main function calls
+# bisect::bicla::write_completion_files with the same parameters as the
+# program, and runs it to produce, in DESTINATION:
+#   <name>.bash  bash completion script
+#   _<name>      zsh completion script
+#   <name>.txt   help page
+#
+# DESTINATION defaults to ${CMAKE_CURRENT_BINARY_DIR}/completion.
+# The generator runs on the build machine, so when cross compiling it must
+# be built with a host toolchain.
+# -------------------------------------------------------------------------
+function(bicla_add_completion target)
+    cmake_parse_arguments(ARG "" "PROGRAM;DESTINATION" "SOURCES" ${ARGN})
+
+    if (NOT ARG_PROGRAM)
+        message(FATAL_ERROR "bicla_add_completion: PROGRAM is required")
+    endif ()
+    if (NOT ARG_SOURCES)
+        message(FATAL_ERROR "bicla_add_completion: SOURCES is required")
+    endif ()
+    if (NOT ARG_DESTINATION)
+        set(ARG_DESTINATION ${CMAKE_CURRENT_BINARY_DIR}/completion)
+    endif ()
+
+    set(generator ${target}_generator)
+    add_executable(${generator} ${ARG_SOURCES})
+    target_link_libraries(${generator} PRIVATE bicla)
+    set_target_properties(${generator} PROPERTIES
+            CXX_STANDARD 17
+            CXX_STANDARD_REQUIRED YES
+            CXX_EXTENSIONS NO
+            )
+
+    set(outputs
+            ${ARG_DESTINATION}/${ARG_PROGRAM}.bash
+            ${ARG_DESTINATION}/_${ARG_PROGRAM}
+            ${ARG_DESTINATION}/${ARG_PROGRAM}.txt
+            )
+
+    add_custom_command(OUTPUT ${outputs}
+            COMMAND ${CMAKE_COMMAND} -E make_directory ${ARG_DESTINATION}
+            COMMAND ${generator} ${ARG_DESTINATION} ${ARG_PROGRAM}
+            DEPENDS ${generator}
+            COMMENT "Generating completion and help for ${ARG_PROGRAM}"
+            VERBATIM
+            )
+
+    add_custom_target(${target} ALL DEPENDS ${outputs})
+endfunction()
@@ -0,0 +1,69 @@
+# -------------------------------------------------------------------------
+# bicla_add_dispatch_order(<target>
+#                          PROFILE <file>
+#                          [NAME <name>]
+#                          [COUNT <count>])
+#
+# Reads a usage profile saved by bisect::bicla::usage_profile and writes a
+# header, <name>.h, that <target> can include. It defines
+#
+#   inline constexpr std::array<std::string_view, N> <name>
+#
+# with the ids of the COUNT most used options, most used first, to be given
+# to incremental_parser::prefer. Options that were never used are left out.
+#
+# NAME defaults to <target>_dispatch_order and COUNT to 8. Without a
+# profile the list is empty. CMake runs again when the profile changes.
+# -------------------------------------------------------------------------
+function(bicla_add_dispatch_order target)
+    cmake_parse_arguments(ARG "" "PROFILE;NAME;COUNT" "" ${ARGN})
+
+    if (NOT ARG_PROFILE)
+        message(FATAL_ERROR "bicla_add_dispatch_order: PROFILE is required")
+    endif ()
+    if (NOT ARG_NAME)
+        string(MAKE_C_IDENTIFIER ${target}_dispatch_order ARG_NAME)
+    endif ()
+    if (NOT ARG_COUNT)
+        set(ARG_COUNT 8)
+    endif ()
+
+    get_filename_component(profile ${ARG_PROFILE} ABSOLUTE)
+
+    # The profile lists the most used parameters first: "<hits> <nanoseconds> <parameter>"
+    set(ids "")
+    set(count 0)
+    if (EXISTS ${profile})
+        set_property(DIRECTORY APPEND PROPERTY CMAKE_CONFIGURE_DEPENDS ${profile})
+
+        file(STRINGS ${profile} lines)
+        foreach (line IN LISTS lines)
+            if (count EQUAL ARG_COUNT)
+                break()
+            endif ()
+            if (line MATCHES "^0*([1-9][0-9]*) [0-9]+ -(.+)$")
+                string(REPLACE "\\" "\\\\" id "${CMAKE_MATCH_2}")
+                string(REPLACE "\"" "\\\"" id "${id}")
+                string(APPEND ids "    \"${id}\",\n")
+                math(EXPR count "${count} + 1")
+            endif ()
+        endforeach ()
+    endif ()
+
+    set(directory ${CMAKE_CURRENT_BINARY_DIR}/dispatch_order)
+    file(WRITE ${directory}/${ARG_NAME}.h.in
+            "// Generated by bicla_add_dispatch_order from ${profile}\n"
+            "#pragma once\n"
+            "\n"
+            "#include <array>\n"
+            "#include <string_view>\n"
+            "\n"
+            "inline constexpr std::array<std::string_view, ${count}> ${ARG_NAME} = {{\n"
+            "${ids}"
+            "}};\n"
+            )
+    # Only touch the header when its contents change, so that the target is not rebuilt on every run
+    configure_file(${directory}/${ARG_NAME}.h.in ${directory}/${ARG_NAME}.h COPYONLY)
+
+    target_include_directories(${target} PRIVATE ${directory})
+endfunction()
@@ -1,18 +1,253 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
 #include <iostream>
+#include <memory>
 #include <optional>
 #include <sstream>
+#include <string_view>
+#include <tuple>
+#include <utility>
 #include <vector>
 
+#if __has_include(<memory_resource>)
+#define BICLA_HAS_MEMORY_RESOURCE 1
+#include <memory_resource>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BICLA_HAS_SSE2 1
+#include <emmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
 //------------------------------------------------------------------------------
 
 namespace bisect::bicla
 {
+    // A view over the trailing entries of argv, as captured by a rest parameter.
+    // It refers to the original argv, which must outlive it. Since the view always ends at argv[argc], which
+    // the C++ standard guarantees to be a null pointer for main's argv, data() can be passed to execv as is.
+    class argv_span
+    {
+      public:
+        using value_type     = const char*;
+        using const_iterator = const char* const*;
+
+        constexpr argv_span() noexcept = default;
+        constexpr argv_span(const char* const* data, std::size_t size) noexcept : data_(data), size_(size) {}
+
+        constexpr const char* const* data() const noexcept { return data_; }
+        constexpr std::size_t size() const noexcept { return size_; }
+        constexpr bool empty() const noexcept { return size_ == 0; }
+
+        constexpr const_iterator begin() const noexcept { return data_; }
+        constexpr const_iterator end() const noexcept { return data_ + size_; }
+
+        constexpr const char* operator[](std::size_t i) const noexcept { return data_[i]; }
+
+        friend bool operator==(const argv_span& a, const argv_span& b) noexcept
+        {
+            return a.data_ == b.data_ && a.size_ == b.size_;
+        }
+
+        friend bool operator!=(const argv_span& a, const argv_span& b) noexcept { return !(a == b); }
+
+      private:
+        const char* const* data_ = nullptr;
+        std::size_t size_        = 0;
+    };
+
     namespace detail
     {
-        template <typename C, typename T> struct argument
+        // The type each token is converted to
+        template <typename T> struct element_of
+        {
+            using type = T;
+        };
+
+        template <typename T> struct element_of<std::optional<T>>
+        {
+            using type = T;
+        };
+
+        template <typename T, typename A> struct element_of<std::vector<T, A>>
+        {
+            using type = T;
+        };
+
+        template <typename T> using element_of_t = typename element_of<T>::type;
+
+        // Character types are read and rendered as a single character, not as a number
+        template <typename T>
+        constexpr bool is_character =
+            std::is_same_v<T, char> || std::is_same_v<T, signed char> || std::is_same_v<T, unsigned char>;
+
+        template <typename T, typename = void> struct is_ordered : std::false_type
+        {
+        };
+
+        template <typename T>
+        struct is_ordered<T, std::void_t<decltype(std::declval<const T&>() < std::declval<const T&>())>>
+            : std::true_type
+        {
+        };
+
+        // Types whose values are given as several tokens, one per component
+        template <typename T> struct is_tuple_like : std::false_type
+        {
+        };
+
+        template <typename T, std::size_t N> struct is_tuple_like<std::array<T, N>> : std::true_type
+        {
+        };
+
+        template <typename T, typename U> struct is_tuple_like<std::pair<T, U>> : std::true_type
+        {
+        };
+
+        template <typename... Ts> struct is_tuple_like<std::tuple<Ts...>> : std::true_type
+        {
+        };
+
+        template <typename T> struct is_string_view : std::false_type
+        {
+        };
+
+        template <typename Ch, typename Traits>
+        struct is_string_view<std::basic_string_view<Ch, Traits>> : std::true_type
+        {
+        };
+
+        // Whether a value, or one of its components, would be a view into a token. parse converts a copy of argv,
+        // so such a view would not outlive it.
+        template <typename T> constexpr bool refers_to_token();
+
+        template <typename T, std::size_t... Is> constexpr bool refers_to_token(std::index_sequence<Is...>)
+        {
+            return (refers_to_token<std::tuple_element_t<Is, T>>() || ...);
+        }
+
+        template <typename T> constexpr bool refers_to_token()
+        {
+            using element_type = element_of_t<T>;
+            if constexpr(is_tuple_like<element_type>::value)
+            {
+                return refers_to_token<element_type>(std::make_index_sequence<std::tuple_size_v<element_type>>{});
+            }
+            else
+            {
+                return is_string_view<element_type>::value;
+            }
+        }
+
+        // The number of tokens a value takes
+        template <typename T, typename = void> struct arity : std::integral_constant<std::size_t, 1>
+        {
+        };
+
+        template <typename T>
+        struct arity<T, std::enable_if_t<is_tuple_like<T>::value>>
+            : std::integral_constant<std::size_t, std::tuple_size_v<T>>
+        {
+        };
+
+        template <typename T> struct arity<std::optional<T>> : arity<T>
+        {
+        };
+
+        template <typename T, typename A> struct arity<std::vector<T, A>> : arity<T>
+        {
+        };
+
+        template <typename T, typename = void> struct is_streamable : std::false_type
+        {
+        };
+
+        template <typename T>
+        struct is_streamable<T, std::void_t<decltype(std::declval<std::ostream&>() << std::declval<const T&>())>>
+            : std::true_type
+        {
+        };
+
+        // Multi-value types compare lexicographically, which is not what a range means
+        template <typename T> constexpr bool has_range = is_ordered<T>::value && !is_tuple_like<T>::value;
+
+        template <const auto& Table, typename V> bool is_one_of(const V& value)
+        {
+            for(const auto& choice : Table)
+            {
+                if(choice == value) return true;
+            }
+
+            return false;
+        }
+
+        template <const auto& Table> void describe_choices(std::ostream& os, const char* separator)
+        {
+            auto first = true;
+            for(const auto& choice : Table)
+            {
+                os << (first ? "" : separator) << choice;
+                first = false;
+            }
+        }
+
+        // Checked on every converted value, once it is stored: a rejected value is left in the configuration, which
+        // is only valid if parsing succeeded
+        template <typename V> struct constraint
+        {
+            std::optional<std::pair<V, V>> range;
+
+            bool (*choices)(const V&)                                         = nullptr;
+            void (*describe_choices)(std::ostream& os, const char* separator) = nullptr;
+
+            bool (*check)(const V&) = nullptr;
+            std::string check_message;
+        };
+
+        // Adds the constraint setters to argument and option
+        template <typename D, typename V> struct constrained
+        {
+            // Values must be in [low, high]
+            D range(V low, V high) const
+            {
+                static_assert(has_range<V>,
+                              "range needs an ordered single-value type: use check for multi-value types");
+
+                auto d              = static_cast<const D&>(*this);
+                d.constraints.range = std::pair<V, V>(std::move(low), std::move(high));
+                return d;
+            }
+
+            // Values must be equal to one of the elements of Table, a constexpr array with static storage, such as
+            // static constexpr std::array<std::string_view, 2> modes{"fast", "safe"};
+            template <const auto& Table> D choices() const
+            {
+                auto d                         = static_cast<const D&>(*this);
+                d.constraints.choices          = &is_one_of<Table, V>;
+                d.constraints.describe_choices = &describe_choices<Table>;
+                return d;
+            }
+
+            // Values must satisfy the predicate; message explains why they did not
+            D check(bool (*predicate)(const V&), std::string message) const
+            {
+                auto d                      = static_cast<const D&>(*this);
+                d.constraints.check         = predicate;
+                d.constraints.check_message = std::move(message);
+                return d;
+            }
+        };
+
+        template <typename C, typename T> struct argument : constrained<argument<C, T>, element_of_t<T>>
         {
             using config_type = C;
             typedef T(C::*pmv);
@@ -21,9 +256,10 @@ namespace bisect::bicla
             const pmv p;
             const std::string short_description;
             const std::string long_description;
+            constraint<element_of_t<T>> constraints;
         };
 
-        template <typename C, typename T> struct option
+        template <typename C, typename T> struct option : constrained<option<C, T>, element_of_t<T>>
         {
             using config_type = C;
             typedef T(C::*pmv);
@@ -33,10 +269,25 @@ namespace bisect::bicla
             const std::string id;
             const std::string short_description;
             const std::string long_description;
+            constraint<element_of_t<T>> constraints;
+        };
+
+        // Everything after a "--" separator
+        template <typename C> struct rest
+        {
+            using config_type = C;
+            typedef argv_span(C::*pmv);
+            using value_type = argv_span;
+
+            const pmv p;
+            const std::string short_description;
+            const std::string long_description;
         };
 
         using svector = std::vector<std::string>;
 
+        inline constexpr const char* rest_separator = "--";
+
         //---------------------------------------------------------------------
 
         template <typename C, typename Option> struct is_option
@@ -51,16 +302,45 @@ namespace bisect::bicla
             static constexpr bool value = std::is_convertible_v<Argument, detail::argument<C, value_type>>;
         };
 
+        template <typename C, typename Rest> struct is_rest
+        {
+            static constexpr bool value = std::is_convertible_v<Rest, detail::rest<C>>;
+        };
+
+        template <typename C, typename... Ts> constexpr bool has_rest = std::disjunction_v<is_rest<C, Ts>...>;
+
+        template <typename C, typename... Ts>
+        constexpr std::size_t rest_count = (std::size_t{0} + ... + std::size_t{is_rest<C, Ts>::value});
+
         template <typename T> constexpr bool is_optional(T) { return false; }
 
         template <typename T> constexpr bool is_optional(std::vector<T>) { return true; }
 
         template <typename T> constexpr bool is_optional(std::optional<T>) { return true; }
 
+        template <typename T> struct is_vector : std::false_type
+        {
+        };
+
+        template <typename T, typename A> struct is_vector<std::vector<T, A>> : std::true_type
+        {
+        };
+
         template <typename T> constexpr bool is_boolean(T) { return false; }
 
         constexpr bool is_boolean(bool) { return true; }
 
+        template <typename C, typename T> constexpr bool is_required()
+        {
+            using value_type = typename T::value_type;
+            return !is_rest<C, T>::value && !is_optional(value_type{}) && !is_boolean(value_type{});
+        }
+
+        inline bool is_marker(std::string_view token, std::string_view id) noexcept
+        {
+            return token.size() == id.size() + 1 && token[0] == '-' && token.substr(1) == id;
+        }
+
         template <int N, typename... Ts> using nth_type_of = typename std::tuple_element<N, std::tuple<Ts...>>::type;
 
         template <typename... Ts> struct get_config_type
@@ -69,90 +349,301 @@ namespace bisect::bicla
             using type    = typename first_t::config_type;
         };
 
+        // Whether Ts is a non-empty list of parameters describing C
+        template <typename C, typename... Ts>
+        constexpr bool is_config_of =
+            std::conjunction_v<std::bool_constant<(sizeof...(Ts) > 0)>, std::is_same<C, typename Ts::config_type>...>;
+
         //---------------------------------------------------------------------
 
-        template <typename T, typename U> void assign(const T& s, std::optional<U>& target)
+        enum class conversion
+        {
+            ok,
+            invalid,
+            out_of_range,
+            not_a_choice,
+            rejected
+        };
+
+        // Numbers are converted with std::from_chars, which does not allocate; anything it does not accept, and
+        // every other type, goes through operator>>. Either way the whole token must be used.
+        template <typename T, typename U> bool convert(const T& s, U& n)
+        {
+            const std::string_view sv(s);
+
+            if constexpr(std::is_arithmetic_v<U> && !std::is_same_v<U, bool> && !is_character<U>)
+            {
+                const auto r = std::from_chars(sv.data(), sv.data() + sv.size(), n);
+                if(r.ec == std::errc{} && r.ptr == sv.data() + sv.size()) return true;
+            }
+
+            std::istringstream is{std::string(sv)};
+            return (is >> n) && (is >> std::ws).eof();
+        }
+
+        template <typename T, typename U> bool store(const T& s, U& n)
+        {
+            if constexpr(std::is_assignable_v<U&, const T&>)
+            {
+                n = s;
+                return true;
+            }
+            else
+            {
+                return convert(s, n);
+            }
+        }
+
+        template <std::size_t I = 0, typename T, typename U> bool store_component(const T& s, std::size_t k, U& value)
+        {
+            if constexpr(I < std::tuple_size_v<U>)
+            {
+                if(k == I) return store(s, std::get<I>(value));
+                return store_component<I + 1>(s, k, value);
+            }
+            else
+            {
+                return false;
+            }
+        }
+
+        template <typename V> conversion check(const V& value, const constraint<V>& c)
+        {
+            if constexpr(has_range<V>)
+            {
+                if(c.range && (value < c.range->first || c.range->second < value)) return conversion::out_of_range;
+            }
+
+            if(c.choices && !c.choices(value)) return conversion::not_a_choice;
+            if(c.check && !c.check(value)) return conversion::rejected;
+            return conversion::ok;
+        }
+
+        // Stores token k of a value; multi-value types take one token per component and are checked once complete
+        template <typename T, typename U>
+        conversion assign_value(const T& s, std::size_t k, U& value, const constraint<U>& c)
+        {
+            if constexpr(is_tuple_like<U>::value)
+            {
+                if(!store_component(s, k, value)) return conversion::invalid;
+                return k + 1 == arity<U>::value ? check(value, c) : conversion::ok;
+            }
+            else
+            {
+                if(!store(s, value)) return conversion::invalid;
+                return check(value, c);
+            }
+        }
+
+        template <typename T, typename U>
+        conversion assign(const T& s, std::size_t k, std::optional<U>& target, const constraint<U>& c)
         {
-            if constexpr(std::is_assignable_v<std::optional<U>, T>)
+            if(k == 0) target.emplace();
+            return assign_value(s, k, *target, c);
+        }
+
+        template <typename T, typename U>
+        conversion assign(const T& s, std::size_t k, std::vector<U>& target, const constraint<U>& c)
+        {
+            if constexpr(is_tuple_like<U>::value)
             {
-                target = s;
+                if(k == 0) target.emplace_back();
+                return assign_value(s, k, target.back(), c);
             }
             else
             {
-                std::istringstream is(s);
-                U n;
-                is >> n;
-                target = n;
+                // Not target.back(), which is not a U& for std::vector<bool>
+                U n{};
+                const auto result = assign_value(s, k, n, c);
+                if(result != conversion::invalid) target.push_back(std::move(n));
+                return result;
             }
         }
 
-        template <typename T, typename U> void assign(const T& s, std::vector<U>& target)
+        template <typename T, typename U>
+        conversion assign(const T& s, std::size_t k, U& target, const constraint<U>& c)
+        {
+            return assign_value(s, k, target, c);
+        }
+
+        template <typename E, typename C, typename T>
+        void report(E& errors, const T& parameter, std::string_view token, conversion result)
         {
-            if constexpr(std::is_assignable_v<U, T>)
+            std::ostringstream os;
+            if constexpr(is_option<C, T>::value)
             {
-                target.push_back(s);
+                os << '-' << parameter.id;
             }
             else
             {
-                std::istringstream is(s);
-                U n;
-                is >> n;
-                target.push_back(n);
+                os << '<' << parameter.short_description << '>';
+            }
+
+            os << ": '" << token << "' ";
+
+            const auto& c = parameter.constraints;
+            switch(result)
+            {
+            case conversion::invalid: os << "is not a valid value"; break;
+            case conversion::out_of_range:
+                if constexpr(is_streamable<element_of_t<typename T::value_type>>::value)
+                {
+                    os << "is not in [" << c.range->first << ", " << c.range->second << "]";
+                }
+                else
+                {
+                    os << "is out of range";
+                }
+                break;
+            case conversion::not_a_choice:
+                os << "is not one of ";
+                c.describe_choices(os, ", ");
+                break;
+            case conversion::rejected: os << c.check_message; break;
+            case conversion::ok: break;
             }
+
+            const auto message = os.str();
+            errors.emplace_back().append(message.data(), message.size());
+        }
+
+        // Converts token k of a value, checks it against the parameter's constraints and stores it in the
+        // configuration
+        // returns false, after adding a message to errors, if the token is not acceptable
+        template <typename E, typename C, typename T, typename S>
+        bool assign_parameter(E& errors, C& config, const T& parameter, const S& token, std::size_t k = 0)
+        {
+            const auto result = assign(token, k, config.*(parameter.p), parameter.constraints);
+            if(result == conversion::ok) return true;
+
+            report<E, C>(errors, parameter, token, result);
+            return false;
         }
 
-        template <typename T, typename U> void assign(const T& s, U& target)
+        // Checks a value that was already in the configuration, rather than read from a token, against the
+        // parameter's constraints
+        // returns false, after adding a message to errors, if the value does not satisfy them
+        template <typename E, typename C, typename T> bool check_initial(E& errors, const C& config, const T& parameter)
         {
-            if constexpr(std::is_assignable_v<U, T>)
+            using value_type = typename T::value_type;
+            if constexpr(std::is_same_v<element_of_t<value_type>, value_type>)
             {
-                target = s;
+                const auto& value = config.*(parameter.p);
+                const auto result = check(value, parameter.constraints);
+                if(result == conversion::ok) return true;
+
+                std::ostringstream token;
+                if constexpr(is_streamable<value_type>::value)
+                {
+                    token << value;
+                }
+                else
+                {
+                    token << "initial value";
+                }
+
+                report<E, C>(errors, parameter, token.str(), result);
+                return false;
             }
             else
             {
-                std::istringstream is(s);
-                U n;
-                is >> n;
-                target = n;
+                return true;
+            }
+        }
+
+        // Values that own memory the configuration refers to, such as mapped_span, hand it over to the parse result
+        // through release_resource()
+        template <typename T, typename = void> struct has_resource : std::false_type
+        {
+        };
+
+        template <typename T>
+        struct has_resource<T, std::void_t<decltype(std::declval<T&>().release_resource())>> : std::true_type
+        {
+        };
+
+        template <typename R, typename T> void collect_resource(R& resources, T& value)
+        {
+            if constexpr(has_resource<T>::value)
+            {
+                if(auto resource = value.release_resource()) resources.push_back(std::move(resource));
+            }
+        }
+
+        template <typename R, typename T> void collect_resource(R& resources, std::optional<T>& value)
+        {
+            if(value) collect_resource(resources, *value);
+        }
+
+        template <typename R, typename T, typename A> void collect_resource(R& resources, std::vector<T, A>& values)
+        {
+            if constexpr(has_resource<T>::value)
+            {
+                for(auto& value : values)
+                {
+                    collect_resource(resources, value);
+                }
             }
         }
 
-        template <typename C, typename T>
-        bool do_parse(svector& args, C& config, const detail::argument<C, T>& argument)
+        template <typename R, typename C, typename... Ts>
+        void collect_resources(R& resources, C& config, const Ts&... parameters)
+        {
+            const auto collect = [&](const auto& parameter) {
+                using T = std::decay_t<decltype(parameter)>;
+                if constexpr(!is_rest<C, T>::value) collect_resource(resources, config.*(parameter.p));
+            };
+            (collect(parameters), ...);
+        }
+
+        // Keeps the element at it, moving it down to kept
+        template <typename It> void keep(It& kept, It it)
+        {
+            if(kept != it) *kept = std::move(*it);
+            ++kept;
+        }
+
+        // Each do_parse overload removes the elements it consumes from args, in place, and adds a message to errors
+        // for each value it rejects.
+        // initialized: config already holds a value for the parameter, such as one set by a preset, so it is not
+        // required; a value kept that way must still satisfy the parameter's constraints
+        template <typename V, typename C, typename T>
+        bool do_parse(V& args, V& errors, C& config, bool initialized, const detail::argument<C, T>& argument)
         {
             bool in_option = false;
             bool done      = false;
 
-            const auto save_args = args;
-            args.clear();
-
-            for(const auto& arg : save_args)
+            auto kept = args.begin();
+            for(auto it = args.begin(); it != args.end(); ++it)
             {
                 if(done)
                 {
-                    args.push_back(arg);
+                    keep(kept, it);
                     continue;
                 }
 
-                if(arg == "-")
+                if(*it == "-")
                 {
                     in_option = true;
-                    args.push_back(arg);
+                    keep(kept, it);
                     continue;
                 }
 
                 if(in_option)
                 {
                     in_option = false;
-                    args.push_back(arg);
+                    keep(kept, it);
                 }
                 else
                 {
                     done = true;
-                    assign(arg, (config.*(argument.p)));
+                    if(!assign_parameter(errors, config, argument, *it)) return false;
                 }
             }
+            args.erase(kept, args.end());
 
             if(in_option) return false;
+            if(!done && initialized) return check_initial(errors, config, argument);
 
             // TODO: this should be constexpr and not force an instantiation
             if(is_optional(T{}))
@@ -165,37 +656,42 @@ namespace bisect::bicla
             }
         }
 
-        // An option that has an argument of type T
-        template <typename C, typename T> bool do_parse(svector& args, C& config, const detail::option<C, T>& option)
+        // An option that has an argument of type T, given as arity<T> tokens
+        template <typename V, typename C, typename T>
+        bool do_parse(V& args, V& errors, C& config, bool initialized, const detail::option<C, T>& option)
         {
-            bool in_option = false;
-            bool done      = false;
+            constexpr auto n = arity<T>::value;
 
-            const auto option_marker = std::string("-") + option.id;
-            const auto save_args     = args;
-            args.clear();
+            std::size_t pending = 0;
+            bool done           = false;
 
-            for(const auto& arg : save_args)
+            auto kept = args.begin();
+            for(auto it = args.begin(); it != args.end(); ++it)
             {
-                if(arg == option_marker)
+                if(is_marker(*it, option.id))
                 {
-                    in_option = true;
+                    // The previous value is not complete
+                    if(pending > 0) return false;
+
+                    pending = n;
                     continue;
                 }
 
-                if(in_option)
+                if(pending > 0)
                 {
-                    in_option = false;
-                    done      = true;
-                    assign(arg, (config.*(option.p)));
+                    const auto k = n - pending--;
+                    done         = true;
+                    if(!assign_parameter(errors, config, option, *it, k)) return false;
                 }
                 else
                 {
-                    args.push_back(arg);
+                    keep(kept, it);
                 }
             }
+            args.erase(kept, args.end());
 
-            if(in_option) return false;
+            if(pending > 0) return false;
+            if(!done && initialized) return check_initial(errors, config, option);
 
             // TODO: this should be constexpr and not force an instantiation
             if(is_optional(T{}))
@@ -209,111 +705,157 @@ namespace bisect::bicla
         }
 
         // A boolean option, with no argument
-        template <typename C> bool do_parse(svector& args, C& config, const detail::option<C, bool>& option)
+        template <typename V, typename C>
+        bool do_parse(V& args, V& /*errors*/, C& config, bool /*initialized*/, const detail::option<C, bool>& option)
         {
             bool done = false;
 
-            const auto option_marker = std::string("-") + option.id;
-            const auto save_args     = args;
-            args.clear();
-
-            for(const auto& arg : save_args)
+            auto kept = args.begin();
+            for(auto it = args.begin(); it != args.end(); ++it)
             {
-                if(done)
-                {
-                    args.push_back(arg);
-                    continue;
-                }
-
-                if(arg == option_marker)
+                if(!done && is_marker(*it, option.id))
                 {
                     done               = true;
                     config.*(option.p) = true;
                     continue;
                 }
 
-                args.push_back(arg);
+                keep(kept, it);
             }
+            args.erase(kept, args.end());
 
             return true;
         }
 
-        template <typename C, typename T> bool do_parse(svector& args, C& /*config*/, const T& wanted)
+        // The tail is not in args: it was split off before parsing and is assigned by assign_rest
+        template <typename V, typename C>
+        bool do_parse(V& /*args*/, V& /*errors*/, C& /*config*/, bool /*initialized*/, const detail::rest<C>& /*rest*/)
         {
-            if constexpr(is_argument<C, T>::value)
+            return true;
+        }
+
+        template <typename C, typename T, typename... Ts>
+        void assign_rest(C& config, argv_span tail, const T& parameter, const Ts&... other)
+        {
+            if constexpr(is_rest<C, T>::value)
             {
-                using argument_type           = detail::argument<C, typename is_argument<C, T>::value_type>;
-                const argument_type& argument = wanted;
-                return do_parse(argument);
+                config.*(parameter.p) = tail;
             }
-            else if constexpr(is_option<C, T>::value)
+
+            if constexpr(sizeof...(Ts) > 0)
             {
-                using argument_type         = detail::option<C, typename is_option<C, T>::value_type>;
-                const argument_type& option = wanted;
-                return do_parse(option);
+                assign_rest(config, tail, other...);
             }
         }
 
-        template <typename C, typename T, typename... Ts>
-        bool do_parse(svector& args, C& config, const T& option, Ts... options)
+        // returns the number of value tokens that follow token, if it is the marker of one of the options
+        template <typename C, typename... Ts> std::size_t values_after(std::string_view token, const Ts&... parameters)
         {
-            if(!do_parse(args, config, option))
-            {
-                return false;
-            }
+            std::size_t n    = 0;
+            const auto count = [&](const auto& parameter) {
+                using T = std::decay_t<decltype(parameter)>;
+                if constexpr(is_option<C, T>::value && !std::is_same_v<typename T::value_type, bool>)
+                {
+                    if(n == 0 && is_marker(token, parameter.id)) n = arity<typename T::value_type>::value;
+                }
+            };
+            (count(parameters), ...);
+            return n;
+        }
 
-            return do_parse(args, config, options...);
+        // Runs the pass of each parameter in turn, stopping at the first that fails.
+        // initialized(parameter) tells whether config already holds a value for the parameter.
+        // observe(parameter, args, pass) runs pass() and returns its result; profiling parse hooks in there.
+        template <typename V, typename C, typename I, typename O, typename... Ts>
+        bool do_parse_all(V& args, V& errors, C& config, const I& initialized, O& observe, const Ts&... parameters)
+        {
+            return (observe(parameters, static_cast<const V&>(args),
+                            [&]() { return do_parse(args, errors, config, initialized(parameters), parameters); }) &&
+                    ...);
         }
 
+        struct uninitialized
+        {
+            template <typename T> bool operator()(const T&) const { return false; }
+        };
+
+        struct unobserved
+        {
+            template <typename T, typename V, typename F> bool operator()(const T&, const V&, F&& pass) const
+            {
+                return pass();
+            }
+        };
+
         //---------------------------------------------------------------------
 
-        template <typename C, typename T> std::string get_full_short_description(const T& parameter)
+        template <typename C, typename S, typename T> void append_full_short_description(S& out, const T& parameter)
         {
-            if constexpr(is_argument<C, T>::value)
+            if constexpr(is_rest<C, T>::value)
             {
-                return "<" + parameter.short_description + ">";
+                out.append(rest_separator).append(" <").append(parameter.short_description).append(">...");
+            }
+            else if constexpr(is_argument<C, T>::value)
+            {
+                out.append("<").append(parameter.short_description).append(">");
             }
             else if constexpr(is_option<C, T>::value)
             {
-                return "-" + parameter.id + " <" + parameter.short_description + ">";
+                out.append("-").append(parameter.id).append(" <").append(parameter.short_description).append(">");
+
+                constexpr auto n = arity<typename T::value_type>::value;
+                if constexpr(n > 1)
+                {
+                    char buffer[24];
+                    const auto r = std::to_chars(buffer, buffer + sizeof(buffer), n);
+                    out.append("{").append(buffer, static_cast<std::size_t>(r.ptr - buffer)).append("}");
+                }
             }
             else
             {
                 assert(false);
-                return "";
             }
         }
 
-        template <typename C, typename T> std::string build_usage_message(const T& parameter)
+        template <typename C, typename S, typename T> void append_usage_message(S& out, const T& parameter)
         {
-            const auto d = get_full_short_description<C>(parameter);
-
-            if(is_optional(typename T::value_type{}) || is_boolean(typename T::value_type{}))
+            if(is_rest<C, T>::value || is_optional(typename T::value_type{}) || is_boolean(typename T::value_type{}))
             {
-                return "[" + d + "]";
+                out.append("[");
+                append_full_short_description<C>(out, parameter);
+                out.append("]");
             }
             else
             {
-                return d;
+                append_full_short_description<C>(out, parameter);
             }
         }
 
-        template <typename C, typename T, typename... Ts>
-        std::string build_usage_message(const T& parameter, const Ts&... other)
+        template <typename C, typename S, typename T, typename... Ts>
+        void append_usage_message(S& out, const T& parameter, const Ts&... other)
         {
-            // TODO: fold expressions would be nice, if VS supported them
-            return build_usage_message<C>(parameter) + " " + build_usage_message<C>(other...);
+            append_usage_message<C>(out, parameter);
+            out.append(" ");
+            append_usage_message<C>(out, other...);
+        }
+
+        template <typename C, typename... Ts> std::string build_usage_message(const Ts&... parameters)
+        {
+            std::string out;
+            append_usage_message<C>(out, parameters...);
+            return out;
         }
 
         //---------------------------------------------------------------------
 
-        template <typename T> void do_build_parameters_description(svector& v, const T& parameter)
+        template <typename V, typename T> void do_build_parameters_description(V& v, const T& parameter)
         {
-            v.push_back(parameter.short_description + ": " + parameter.long_description);
+            auto& s = v.emplace_back();
+            s.append(parameter.short_description).append(": ").append(parameter.long_description);
         }
 
-        template <typename T, typename... Ts>
-        void do_build_parameters_description(svector& v, const T& parameter, const Ts&... other)
+        template <typename V, typename T, typename... Ts>
+        void do_build_parameters_description(V& v, const T& parameter, const Ts&... other)
         {
             do_build_parameters_description(v, parameter);
             do_build_parameters_description(v, other...);
@@ -327,15 +869,104 @@ namespace bisect::bicla
         }
     } // namespace detail
 
-    struct parse_result
+    template <typename Allocator = std::allocator<char>> struct basic_parse_result
     {
-        const bool success;
-        const std::string usage_message;
-        const detail::svector parameters_description;
+        using allocator_type = Allocator;
+        using string_type    = std::basic_string<char, std::char_traits<char>, Allocator>;
+        using vector_type =
+            std::vector<string_type, typename std::allocator_traits<Allocator>::template rebind_alloc<string_type>>;
+        using resource_type   = std::shared_ptr<const void>;
+        using resource_vector =
+            std::vector<resource_type, typename std::allocator_traits<Allocator>::template rebind_alloc<resource_type>>;
+
+        // Not const, so that moving the result keeps the allocator
+        bool success;
+        string_type usage_message;
+        vector_type parameters_description;
+
+        // One message for each value that could not be converted or did not satisfy its parameter's constraints
+        vector_type errors;
+
+        // Memory that values in the configuration refer to, such as the files mapped for mapped_span options.
+        // The configuration must not be used after the result is destroyed.
+        resource_vector resources;
 
         explicit operator bool() const noexcept { return success; }
     };
 
+    using parse_result = basic_parse_result<>;
+
+    namespace detail
+    {
+        // initialized(parameter): whether config, given by the caller, already holds a value for the parameter, which
+        // is then kept if the parameter is missing from argv
+        template <typename Allocator, typename I, typename O, typename... Ts>
+        auto parse_with(const Allocator& allocator, typename get_config_type<Ts...>::type config, I initialized,
+                        O observe, int argc, const char* const argv[], const Ts&... options)
+            -> std::tuple<basic_parse_result<Allocator>, typename get_config_type<Ts...>::type>
+        {
+            assert(argc > 0);
+            using ConfigType = typename get_config_type<Ts...>::type;
+            using Result     = basic_parse_result<Allocator>;
+
+            static_assert(rest_count<ConfigType, Ts...> <= 1, "there can be at most one rest parameter");
+
+            // With a rest parameter, everything after the first "--" is left untouched in argv. A "--" that is the
+            // value of an option is not a separator.
+            auto end = argc;
+            if constexpr(has_rest<ConfigType, Ts...>)
+            {
+                for(auto i = 1; i < argc; ++i)
+                {
+                    if(std::strcmp(argv[i], rest_separator) == 0)
+                    {
+                        end = i;
+                        break;
+                    }
+
+                    i += static_cast<int>(values_after<ConfigType>(argv[i], options...));
+                }
+            }
+
+            // Skip program name
+            typename Result::vector_type arguments(allocator);
+            arguments.reserve(static_cast<std::size_t>(end - 1));
+            for(auto i = 1; i < end; ++i)
+            {
+                arguments.emplace_back(argv[i]);
+            }
+
+            typename Result::vector_type errors(allocator);
+            auto parse_ok = do_parse_all(arguments, errors, config, initialized, observe, options...);
+
+            if constexpr(has_rest<ConfigType, Ts...>)
+            {
+                const auto tail_begin = end < argc ? end + 1 : argc;
+                assign_rest(config, argv_span(argv + tail_begin, static_cast<std::size_t>(argc - tail_begin)),
+                            options...);
+            }
+
+            if(!arguments.empty())
+            {
+                parse_ok = false;
+            }
+
+            typename Result::string_type usage_message(allocator);
+            append_usage_message<ConfigType>(usage_message, options...);
+
+            typename Result::vector_type parameters_description(allocator);
+            parameters_description.reserve(sizeof...(Ts));
+            do_build_parameters_description(parameters_description, options...);
+
+            typename Result::resource_vector resources(allocator);
+            collect_resources(resources, config, options...);
+
+            return {Result{parse_ok, std::move(usage_message), std::move(parameters_description), std::move(errors),
+                           std::move(resources)},
+                    std::move(config)};
+        }
+    } // namespace detail
+
     // returns:
     //  {
     //      parse_result:
@@ -345,56 +976,727 @@ namespace bisect::bicla
     //      configuration: only valid if parsing succeeded
     //  }
     template <typename... Ts>
-    auto parse(int argc, const char* const argv[], Ts... options)
+    auto parse(int argc, const char* const argv[], const Ts&... options)
         -> std::tuple<parse_result, typename detail::get_config_type<Ts...>::type>
     {
-        assert(argc > 0);
-        // Skip program name
-        std::vector<std::string> arguments(argv + 1, argv + argc);
+        return detail::parse_with(std::allocator<char>(), {}, detail::uninitialized{}, detail::unobserved{}, argc, argv,
+                                  options...);
+    }
 
-        using ConfigType = typename detail::get_config_type<Ts...>::type;
-        auto config      = ConfigType{};
-        auto parse_ok    = detail::do_parse(arguments, config, options...);
+    // Same as parse, but starts from the given configuration instead of a value-initialized one: optional
+    // parameters that are not on the command line keep their initial values. Required parameters must still be
+    // given; parse from a preset_result (see bisect/bicla/preset.h) to let the preset provide them.
+    template <typename C, typename... Ts, typename = std::enable_if_t<detail::is_config_of<C, Ts...>>>
+    auto parse(const C& initial, int argc, const char* const argv[], const Ts&... options)
+        -> std::tuple<parse_result, C>
+    {
+        return detail::parse_with(std::allocator<char>(), initial, detail::uninitialized{}, detail::unobserved{}, argc,
+                                  argv, options...);
+    }
 
-        if(!arguments.empty())
-        {
-            parse_ok = false;
-        }
+#if defined(BICLA_HAS_MEMORY_RESOURCE)
+    namespace pmr
+    {
+        using parse_result = basic_parse_result<std::pmr::polymorphic_allocator<char>>;
+    }
 
-        const auto usage_message          = detail::build_usage_message<ConfigType>(options...);
-        const auto parameters_description = detail::build_parameters_description(options...);
-        return {parse_result{parse_ok, usage_message, parameters_description}, config};
+    // Same as parse, but the copy of argv, the error messages and the parse_result are allocated from the given
+    // memory resource. Build the parameters once, outside of the request path, and reuse them: their strings are
+    // not copied.
+    // Converting values can still use the default heap: only numbers that std::from_chars accepts are converted
+    // without allocating. Every other token, such as a bool, an enum or a user type, goes through a
+    // std::istringstream, and so does formatting an error message.
+    // The configuration itself is value-initialized as usual; give it pmr members if it must use the resource too.
+    template <typename... Ts>
+    auto parse(std::pmr::memory_resource* resource, int argc, const char* const argv[], const Ts&... options)
+        -> std::tuple<pmr::parse_result, typename detail::get_config_type<Ts...>::type>
+    {
+        return detail::parse_with(std::pmr::polymorphic_allocator<char>(resource), {}, detail::uninitialized{},
+                                  detail::unobserved{}, argc, argv, options...);
     }
+#endif
 
     template <typename C, typename T>
     detail::argument<C, T> argument(T C::*_p, std::string _short_description, std::string _long_description = "")
     {
-        return detail::argument<C, T>{_p, _short_description,
-                                      _long_description == "" ? _short_description : _long_description};
+        static_assert(detail::arity<T>::value == 1,
+                      "an argument takes a single token: use an option for std::array, std::pair and std::tuple");
+        static_assert(!detail::refers_to_token<T>(),
+                      "a string_view would refer to a copy of the token that parse frees: use std::string");
+
+        return detail::argument<C, T>{
+            {}, _p, _short_description, _long_description == "" ? _short_description : _long_description, {}};
     }
 
     template <typename C, typename T>
     detail::option<C, T> option(T C::*_p, std::string _id, std::string _short_description,
                                 std::string _long_description = "")
     {
-        return detail::option<C, T>{_p, _id, _short_description,
-                                    _long_description == "" ? _short_description : _long_description};
+        static_assert(!detail::refers_to_token<T>(),
+                      "a string_view would refer to a copy of the token that parse frees: use std::string");
+
+        return detail::option<C, T>{
+            {}, _p, _id, _short_description, _long_description == "" ? _short_description : _long_description, {}};
+    }
+
+    // Captures everything after the first "--" as a view over the original argv, without copying.
+    // Without a "--" in argv the view is empty and points at argv[argc].
+    template <typename C>
+    detail::rest<C> rest(argv_span C::*_p, std::string _short_description, std::string _long_description = "")
+    {
+        return detail::rest<C>{_p, _short_description,
+                               _long_description == "" ? _short_description : _long_description};
     }
 
-    inline std::string to_string(const parse_result& r)
+    // A parser for tokens that arrive one at a time, for instance from an interactive prompt.
+    // It takes the same parameters as parse and keeps only the state it needs between tokens: which parameters have
+    // been set and whether an option is waiting for its values. Tokens are converted as they are fed, so nothing is
+    // buffered.
+    // Options are recognised wherever they appear; any other token goes to the next argument. A token that cannot be
+    // accepted (an unknown option, an extra argument, a repeated flag or a lone "-") is rejected by feed straight
+    // away, and so is every token after it. Any token that starts with "-" and matches no option is an unknown
+    // option, unless it is a negative number such as "-5" or "-.5", which goes to the next argument.
+    template <typename... Ts> class incremental_parser
     {
-        std::string out = r.usage_message + '\n';
+      public:
+        using config_type = typename detail::get_config_type<Ts...>::type;
+
+        static_assert(!detail::has_rest<config_type, Ts...>, "a rest parameter needs the whole argv");
+
+        explicit incremental_parser(Ts... parameters) : parameters_(std::move(parameters)...)
+        {
+            complete_order({}, 0);
+        }
+
+        // returns false if the token was rejected
+        bool feed(std::string_view token)
+        {
+            if(failed_) return false;
+
+            if(pending_ != no_parameter)
+            {
+                const auto i = pending_;
+                const auto k = component_++;
+                if(component_ == components_) pending_ = no_parameter;
+                return assign(i, token, k);
+            }
+
+            if(!token.empty() && token[0] == '-')
+            {
+                const auto i = find_option(token);
+                if(i != no_parameter) return accept_option(i);
+
+                // A lone dash, or a dash followed by anything but a number, is an unknown option, not an argument
+                const auto number = token.size() > 1 && ((token[1] >= '0' && token[1] <= '9') || token[1] == '.');
+                if(!number)
+                {
+                    failed_ = true;
+                    return false;
+                }
+            }
+
+            const auto i = find_argument(std::index_sequence_for<Ts...>{});
+            if(i == no_parameter)
+            {
+                failed_ = true;
+                return false;
+            }
+
+            set_[i] = true;
+            return assign(i, token);
+        }
+
+        // Makes the options with the given ids, in that order, the first ones tried when matching a token, for
+        // instance the most used options of a usage_profile. Option ids are unique, so this only changes how many
+        // comparisons a token takes, not how it is parsed. Ids that are not options are ignored.
+        template <typename Ids> void prefer(const Ids& ids)
+        {
+            std::array<bool, sizeof...(Ts)> placed{};
+            std::size_t n = 0;
+            for(const auto& id : ids)
+            {
+                const auto i = find_option_id(id, std::index_sequence_for<Ts...>{});
+                if(i != no_parameter && !placed[i])
+                {
+                    placed[i]   = true;
+                    order_[n++] = i;
+                }
+            }
+
+            complete_order(placed, n);
+        }
+
+        // returns the same as parse for the tokens fed so far
+        std::tuple<parse_result, config_type> finish() const
+        {
+            const auto parse_ok = !failed_ && pending_ == no_parameter &&
+                                  has_required(std::index_sequence_for<Ts...>{});
+
+            const auto usage_message = std::apply(
+                [](const auto&... parameters) { return detail::build_usage_message<config_type>(parameters...); },
+                parameters_);
+            const auto parameters_description = std::apply(
+                [](const auto&... parameters) { return detail::build_parameters_description(parameters...); },
+                parameters_);
+            auto config = config_;
+            parse_result::resource_vector resources;
+            std::apply([&](const auto&... parameters) { detail::collect_resources(resources, config, parameters...); },
+                       parameters_);
+
+            return {parse_result{parse_ok, usage_message, parameters_description, errors_, std::move(resources)},
+                    std::move(config)};
+        }
+
+      private:
+        static constexpr std::size_t no_parameter = sizeof...(Ts);
+
+        template <std::size_t I = 0, typename F> void visit(std::size_t i, F&& f) const
+        {
+            if constexpr(I < sizeof...(Ts))
+            {
+                if(i == I)
+                {
+                    f(std::get<I>(parameters_));
+                }
+                else
+                {
+                    visit<I + 1>(i, f);
+                }
+            }
+        }
+
+        using marker_test = bool (incremental_parser::*)(std::string_view) const noexcept;
+
+        template <std::size_t... Is>
+        static constexpr std::array<marker_test, sizeof...(Ts)> marker_tests(std::index_sequence<Is...>) noexcept
+        {
+            return {&incremental_parser::is_option_marker<Is>...};
+        }
+
+        // Follows order_, so that each option is compared at most once
+        std::size_t find_option(std::string_view token) const noexcept
+        {
+            static constexpr auto tests = marker_tests(std::index_sequence_for<Ts...>{});
+
+            for(std::size_t h = 0; h < option_count_; ++h)
+            {
+                const auto i = order_[h];
+                if((this->*tests[i])(token)) return i;
+            }
+
+            return no_parameter;
+        }
+
+        // Appends to the first n entries of order_ the options that are not placed yet, in declaration order
+        void complete_order(const std::array<bool, sizeof...(Ts)>& placed, std::size_t n) noexcept
+        {
+            constexpr std::array<bool, sizeof...(Ts)> is_option{detail::is_option<config_type, Ts>::value...};
+
+            for(std::size_t i = 0; i < sizeof...(Ts); ++i)
+            {
+                if(is_option[i] && !placed[i]) order_[n++] = i;
+            }
+
+            option_count_ = n;
+        }
+
+        template <std::size_t... Is>
+        std::size_t find_option_id(std::string_view id, std::index_sequence<Is...>) const noexcept
+        {
+            auto found = no_parameter;
+            static_cast<void>(((has_option_id<Is>(id) ? (found = Is, true) : false) || ...));
+            return found;
+        }
+
+        template <std::size_t I> bool has_option_id(std::string_view id) const noexcept
+        {
+            if constexpr(detail::is_option<config_type, nth_parameter<I>>::value)
+            {
+                return std::get<I>(parameters_).id == id;
+            }
+            else
+            {
+                return false;
+            }
+        }
+
+        template <std::size_t I> bool is_option_marker(std::string_view token) const noexcept
+        {
+            using T = nth_parameter<I>;
+            if constexpr(detail::is_option<config_type, T>::value)
+            {
+                return detail::is_marker(token, std::get<I>(parameters_).id);
+            }
+            else
+            {
+                return false;
+            }
+        }
+
+        template <std::size_t... Is> std::size_t find_argument(std::index_sequence<Is...>) const noexcept
+        {
+            auto found = no_parameter;
+            static_cast<void>(((is_free_argument<Is>() ? (found = Is, true) : false) || ...));
+            return found;
+        }
+
+        // Like parse, an argument takes a single token, even if it is a vector
+        template <std::size_t I> bool is_free_argument() const noexcept
+        {
+            return detail::is_argument<config_type, nth_parameter<I>>::value && !set_[I];
+        }
+
+        bool assign(std::size_t i, std::string_view token, std::size_t k = 0)
+        {
+            visit(i, [&](const auto& parameter) {
+                if(!detail::assign_parameter(errors_, config_, parameter, token, k)) failed_ = true;
+            });
+
+            return !failed_;
+        }
+
+        bool accept_option(std::size_t i)
+        {
+            auto is_flag = false;
+            visit(i, [&](const auto& parameter) {
+                using value_type = typename std::decay_t<decltype(parameter)>::value_type;
+                if constexpr(std::is_same_v<value_type, bool>)
+                {
+                    is_flag                = true;
+                    config_.*(parameter.p) = true;
+                }
+                else
+                {
+                    components_ = detail::arity<value_type>::value;
+                }
+            });
+
+            // As with parse, a flag is only consumed once
+            if(is_flag && set_[i])
+            {
+                failed_ = true;
+                return false;
+            }
+
+            if(!is_flag)
+            {
+                pending_   = i;
+                component_ = 0;
+            }
+
+            set_[i] = true;
+            return true;
+        }
+
+        template <std::size_t... Is> bool has_required(std::index_sequence<Is...>) const noexcept
+        {
+            return ((!detail::is_required<config_type, nth_parameter<Is>>() || set_[Is]) && ...);
+        }
+
+        template <std::size_t I> using nth_parameter = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+        const std::tuple<Ts...> parameters_;
+        config_type config_{};
+        std::array<bool, sizeof...(Ts)> set_{};
+        detail::svector errors_;
+        std::size_t pending_    = no_parameter;
+        std::size_t component_  = 0;
+        std::size_t components_ = 0;
+        bool failed_            = false;
+
+        // Indices of the options, in the order find_option tries them: the preferred ones first, then the others
+        std::array<std::size_t, sizeof...(Ts)> order_{};
+        std::size_t option_count_ = 0;
+    };
+
+    namespace detail
+    {
+#if defined(BICLA_HAS_SSE2)
+        // Only used on the SSE2 path, which is also the only one that includes <intrin.h> for MSVC
+        inline unsigned count_trailing_zeros(unsigned mask) noexcept
+        {
+            assert(mask != 0);
+#if defined(_MSC_VER)
+            unsigned long index;
+            _BitScanForward(&index, mask);
+            return static_cast<unsigned>(index);
+#else
+            return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+        }
+#endif
+
+        // returns a pointer to the first of the characters Cs in [p, end), or end
+        template <char... Cs> const char* find_first_of(const char* p, const char* end) noexcept
+        {
+#if defined(BICLA_HAS_SSE2)
+            while(end - p >= 16)
+            {
+                const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+                auto hits        = _mm_setzero_si128();
+                ((hits = _mm_or_si128(hits, _mm_cmpeq_epi8(chunk, _mm_set1_epi8(Cs)))), ...);
+
+                const auto mask = static_cast<unsigned>(_mm_movemask_epi8(hits));
+                if(mask != 0) return p + count_trailing_zeros(mask);
+                p += 16;
+            }
+#endif
+            for(; p != end; ++p)
+            {
+                if(((*p == Cs) || ...)) return p;
+            }
+
+            return end;
+        }
+
+        constexpr bool is_blank(char c) noexcept { return c == ' ' || c == '\t' || c == '\n'; }
+
+        // Splits a line into words following the POSIX shell quoting rules: single quotes, double quotes and
+        // backslash escapes. There is no expansion of any kind.
+        // Tokens without quotes or escapes are views into the line; the others are unquoted into a scratch string
+        // that is reused from one token to the next.
+        // returns false if the line ends inside quotes or with a backslash, or as soon as f returns false
+        template <typename F> bool for_each_token(std::string_view line, F&& f)
+        {
+            auto p         = line.data();
+            const auto end = p + line.size();
+            std::string scratch;
+
+            for(;;)
+            {
+                while(p != end && is_blank(*p))
+                {
+                    ++p;
+                }
+
+                if(p == end) return true;
+
+                const auto begin = p;
+                auto unquoted    = false; // the token is being built in scratch
+                auto quoted      = false;
+
+                for(;;)
+                {
+                    const auto q = find_first_of<' ', '\t', '\n', '\'', '"', '\\'>(p, end);
+                    if(unquoted) scratch.append(p, q);
+                    p = q;
+
+                    if(p == end || is_blank(*p)) break;
+
+                    if(!unquoted)
+                    {
+                        scratch.assign(begin, p);
+                        unquoted = true;
+                    }
+
+                    if(*p == '\'')
+                    {
+                        const auto size  = static_cast<std::size_t>(end - p - 1);
+                        const auto close = static_cast<const char*>(std::memchr(p + 1, '\'', size));
+                        if(close == nullptr) return false;
+
+                        scratch.append(p + 1, close);
+                        p      = close + 1;
+                        quoted = true;
+                    }
+                    else if(*p == '"')
+                    {
+                        ++p;
+                        for(;;)
+                        {
+                            const auto r = find_first_of<'"', '\\'>(p, end);
+                            if(r == end) return false;
+
+                            scratch.append(p, r);
+                            p = r + 1;
+                            if(*r == '"') break;
+
+                            // Inside double quotes, a backslash only escapes these
+                            if(p == end) return false;
+                            if(*p == '"' || *p == '\\' || *p == '$' || *p == '`')
+                            {
+                                scratch += *p;
+                            }
+                            else if(*p != '\n')
+                            {
+                                scratch += '\\';
+                                scratch += *p;
+                            }
+
+                            ++p;
+                        }
+
+                        quoted = true;
+                    }
+                    else
+                    {
+                        // A backslash followed by a newline is a line continuation
+                        if(p + 1 == end) return false;
+                        if(p[1] != '\n') scratch += p[1];
+                        p += 2;
+                    }
+                }
+
+                if(unquoted && scratch.empty() && !quoted) continue;
+
+                const auto token =
+                    unquoted ? std::string_view(scratch) : std::string_view(begin, static_cast<std::size_t>(p - begin));
+                if(!f(token)) return false;
+            }
+        }
+    } // namespace detail
+
+    // Parses a command line held in a single string, such as "-mode \"fast path\" -n 10", with the same parameters
+    // as parse. Unlike argv, the line does not start with a program name.
+    // The line is split following the POSIX shell quoting rules and each word goes straight to an
+    // incremental_parser, so parsing stops at the first word that cannot be accepted.
+    // returns: the same as parse. Parsing also fails if the line ends inside quotes or with a backslash.
+    template <typename... Ts>
+    auto parse_line(std::string_view line, Ts... options)
+        -> std::tuple<parse_result, typename detail::get_config_type<Ts...>::type>
+    {
+        incremental_parser<Ts...> parser(options...);
+        const auto split_ok =
+            detail::for_each_token(line, [&parser](std::string_view token) { return parser.feed(token); });
+
+        auto [result, config] = parser.finish();
+        if(!split_ok) result.success = false;
+
+        return {std::move(result), std::move(config)};
+    }
+
+    template <typename Allocator> std::string to_string(const basic_parse_result<Allocator>& r)
+    {
+        std::string out(r.usage_message);
+        out += '\n';
         for(const auto& s : r.parameters_description)
         {
-            out += s + '\n';
+            out.append(s.data(), s.size());
+            out += '\n';
         }
 
         return out;
     }
 
-    inline std::ostream& operator<<(std::ostream& os, const parse_result& r)
+    template <typename Allocator>
+    std::ostream& operator<<(std::ostream& os, const basic_parse_result<Allocator>& r)
     {
         os << to_string(r);
         return os;
     }
+
+    //--------------------------------------------------------------------------
+
+    // A command line rendered by to_argv.
+    // The strings and the null terminated pointer array share a single allocation.
+    class argv_buffer
+    {
+      public:
+        argv_buffer(std::unique_ptr<char*[]> storage, int argc) noexcept : storage_(std::move(storage)), argc_(argc)
+        {
+        }
+
+        int argc() const noexcept { return argc_; }
+
+        // Suitable both for parse and for the exec family of functions
+        char* const* argv() const noexcept { return storage_.get(); }
+
+      private:
+        std::unique_ptr<char*[]> storage_;
+        int argc_;
+    };
+
+    namespace detail
+    {
+        // First pass of to_argv: computes the number of tokens and the number of bytes they need
+        struct argv_measure
+        {
+            std::size_t tokens = 0;
+            std::size_t bytes  = 0;
+
+            void append(std::string_view s) noexcept { bytes += s.size(); }
+
+            void end_token() noexcept
+            {
+                ++bytes;
+                ++tokens;
+            }
+        };
+
+        // Second pass of to_argv: copies the tokens and fills the pointer array
+        struct argv_writer
+        {
+            char** pointers;
+            char* next;
+            char* token_begin;
+
+            void append(std::string_view s) noexcept
+            {
+                std::memcpy(next, s.data(), s.size());
+                next += s.size();
+            }
+
+            void end_token() noexcept
+            {
+                *next++     = '\0';
+                *pointers++ = token_begin;
+                token_begin = next;
+            }
+        };
+
+        template <typename W, typename U> void render_value(W& w, const U& value)
+        {
+            if constexpr(is_tuple_like<U>::value)
+            {
+                // One token per component
+                std::apply([&w](const auto&... components) { (render_value(w, components), ...); }, value);
+                return;
+            }
+            else if constexpr(std::is_same_v<U, bool>)
+            {
+                w.append(value ? "1" : "0");
+            }
+            else if constexpr(is_character<U>)
+            {
+                const auto c = static_cast<char>(value);
+                w.append(std::string_view(&c, 1));
+            }
+            else if constexpr(std::is_arithmetic_v<U>)
+            {
+                char buffer[64];
+                const auto r = std::to_chars(buffer, buffer + sizeof(buffer), value);
+                assert(r.ec == std::errc{});
+                w.append(std::string_view(buffer, static_cast<std::size_t>(r.ptr - buffer)));
+            }
+            else if constexpr(std::is_convertible_v<const U&, std::string_view>)
+            {
+                w.append(value);
+            }
+            else
+            {
+                std::ostringstream os;
+                os << value;
+                w.append(os.str());
+            }
+
+            w.end_token();
+        }
+
+        template <typename W> void render_marker(W& w, const std::string& id)
+        {
+            w.append("-");
+            w.append(id);
+            w.end_token();
+        }
+
+        template <typename W, typename U> void render_argument(W& w, const U& value) { render_value(w, value); }
+
+        template <typename W, typename U> void render_argument(W& w, const std::optional<U>& value)
+        {
+            if(value) render_value(w, *value);
+        }
+
+        template <typename W, typename U> void render_option(W& w, const std::string& id, const U& value)
+        {
+            render_marker(w, id);
+            render_value(w, value);
+        }
+
+        template <typename W> void render_option(W& w, const std::string& id, const bool& value)
+        {
+            if(value) render_marker(w, id);
+        }
+
+        template <typename W, typename U>
+        void render_option(W& w, const std::string& id, const std::optional<U>& value)
+        {
+            if(value)
+            {
+                render_marker(w, id);
+                render_value(w, *value);
+            }
+        }
+
+        template <typename W, typename U>
+        void render_option(W& w, const std::string& id, const std::vector<U>& values)
+        {
+            for(const auto& value : values)
+            {
+                render_marker(w, id);
+                render_value(w, value);
+            }
+        }
+
+        template <typename W, typename C, typename T> void render(W& w, const C& config, const T& parameter)
+        {
+            if constexpr(is_argument<C, T>::value)
+            {
+                // parse gives an argument a single token, so the other elements would not read back
+                static_assert(!is_vector<typename T::value_type>::value, "a vector argument cannot be rendered");
+                render_argument(w, config.*(parameter.p));
+            }
+            else if constexpr(is_option<C, T>::value)
+            {
+                render_option(w, parameter.id, config.*(parameter.p));
+            }
+        }
+
+        template <typename W, typename C, typename T> void render_tail(W& w, const C& config, const T& parameter)
+        {
+            if constexpr(is_rest<C, T>::value)
+            {
+                const auto& tail = config.*(parameter.p);
+                if(tail.empty()) return;
+
+                w.append(rest_separator);
+                w.end_token();
+
+                for(const auto token : tail)
+                {
+                    w.append(token);
+                    w.end_token();
+                }
+            }
+        }
+
+        // The tail goes last, wherever the rest parameter is in the list: everything after the separator is in it
+        template <typename W, typename C, typename... Ts>
+        void render_all(W& w, const C& config, const Ts&... parameters)
+        {
+            (render(w, config, parameters), ...);
+            (render_tail(w, config, parameters), ...);
+        }
+    } // namespace detail
+
+    // The reverse of parse: renders a configuration as a command line, so that parsing the result with the same
+    // parameters yields the same configuration.
+    // Parameters are rendered in order, except for the rest parameter, which is always rendered last. Numbers are
+    // formatted with std::to_chars, which gives the shortest representation that reads back to the same value.
+    // Vector arguments are rejected: parse gives an argument a single token.
+    // Values are rendered verbatim, so a string value that looks like an option marker will not round trip.
+    template <typename C, typename... Ts>
+    argv_buffer to_argv(std::string_view program_name, const C& config, const Ts&... parameters)
+    {
+        static_assert(std::is_same_v<C, typename detail::get_config_type<Ts...>::type>,
+                      "the parameters must describe the configuration type");
+
+        detail::argv_measure measure;
+        measure.append(program_name);
+        measure.end_token();
+        detail::render_all(measure, config, parameters...);
+
+        // Pointers first, including the terminating null, followed by the characters
+        const auto pointer_count = measure.tokens + 1;
+        const auto char_slots    = (measure.bytes + sizeof(char*) - 1) / sizeof(char*);
+        auto storage             = std::unique_ptr<char*[]>(new char*[pointer_count + char_slots]);
+
+        const auto chars = reinterpret_cast<char*>(storage.get() + pointer_count);
+        detail::argv_writer writer{storage.get(), chars, chars};
+        writer.append(program_name);
+        writer.end_token();
+        detail::render_all(writer, config, parameters...);
+        *writer.pointers = nullptr;
+
+        return argv_buffer(std::move(storage), static_cast<int>(measure.tokens));
+    }
 } // namespace bisect::bicla
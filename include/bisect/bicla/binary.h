@@ -0,0 +1,346 @@
+#pragma once
+
+#include "bisect/bicla.h"
+
+#include <cstdint>
+
+//------------------------------------------------------------------------------
+// A compact binary encoding of a parsed configuration, so that a worker process can receive its configuration
+// from its parent without parsing a command line again.
+//
+// Layout, in native byte order:
+//  header:  magic, version, parameter count, layout signature, records size, arena size
+//  records: one record per parameter, in order. Fixed-size values are stored inline; bools as a byte of 0 or 1;
+//           strings as an offset and a length into the arena; optionals as a presence byte followed by the value;
+//           vectors as an element count followed by the elements; pairs and tuples as their components.
+//  arena:   the characters of all strings
+//
+// The layout signature is derived from the parameters, so a blob is only accepted by a process that was built
+// with the same parameter list. How the blob reaches the worker (a pipe, an inherited fd, a memfd, ...) is up
+// to the caller; it is read with memcpy, so it does not need to be aligned.
+//------------------------------------------------------------------------------
+
+namespace bisect::bicla
+{
+    namespace detail
+    {
+        inline constexpr std::uint32_t binary_magic   = 0x414c4342; // "BCLA"
+        inline constexpr std::uint16_t binary_version = 1;
+
+        struct binary_header
+        {
+            std::uint32_t magic;
+            std::uint16_t version;
+            std::uint16_t parameter_count;
+            std::uint64_t signature;
+            std::uint32_t records_size;
+            std::uint32_t arena_size;
+        };
+
+        //---------------------------------------------------------------------
+
+        // FNV-1a
+        struct binary_signature
+        {
+            std::uint64_t value = 0xcbf29ce484222325ull;
+
+            void add(std::string_view s) noexcept
+            {
+                for(const auto c : s)
+                {
+                    value ^= static_cast<unsigned char>(c);
+                    value *= 0x100000001b3ull;
+                }
+            }
+
+            void add(std::uint64_t n) noexcept
+            {
+                for(auto i = 0; i < 8; ++i)
+                {
+                    value ^= (n >> (8 * i)) & 0xff;
+                    value *= 0x100000001b3ull;
+                }
+            }
+        };
+
+        template <typename T> struct is_binary_string : std::false_type
+        {
+        };
+
+        template <typename Traits, typename Allocator>
+        struct is_binary_string<std::basic_string<char, Traits, Allocator>> : std::true_type
+        {
+        };
+
+        template <typename T> constexpr bool contains_bool();
+
+        template <typename T, std::size_t... Is> constexpr bool contains_bool(std::index_sequence<Is...>)
+        {
+            return (contains_bool<std::tuple_element_t<Is, T>>() || ...);
+        }
+
+        template <typename T> constexpr bool contains_bool()
+        {
+            if constexpr(is_tuple_like<T>::value)
+            {
+                return contains_bool<T>(std::make_index_sequence<std::tuple_size_v<T>>{});
+            }
+            else
+            {
+                return std::is_same_v<T, bool>;
+            }
+        }
+
+        // Only a byte of 0 or 1 is a bool, so bools, and pairs, tuples and arrays holding them, are not copied as
+        // they are but stored and checked one component at a time
+        template <typename T> constexpr bool is_binary_trivial =
+            std::is_trivially_copyable_v<T> && !std::is_pointer_v<T> && !std::is_member_pointer_v<T> &&
+            !std::is_same_v<T, argv_span> && !contains_bool<T>();
+
+        template <typename T> void add_type_signature(binary_signature& s, const T*)
+        {
+            if constexpr(is_binary_string<T>::value)
+            {
+                s.add("s");
+            }
+            else if constexpr(std::is_same_v<T, bool>)
+            {
+                s.add("b");
+            }
+            else if constexpr(is_tuple_like<T>::value && !is_binary_trivial<T>)
+            {
+                s.add("t");
+                std::apply([&s](const auto&... c) { (add_type_signature(s, &c), ...); }, T{});
+            }
+            else
+            {
+                static_assert(is_binary_trivial<T>, "this type cannot be stored in a binary configuration");
+                s.add(std::is_floating_point_v<T> ? "f" : std::is_integral_v<T> ? "i" : "r");
+                s.add(std::uint64_t{sizeof(T)});
+            }
+        }
+
+        template <typename U> void add_type_signature(binary_signature& s, const std::optional<U>*)
+        {
+            s.add("o");
+            add_type_signature(s, static_cast<const U*>(nullptr));
+        }
+
+        template <typename U> void add_type_signature(binary_signature& s, const std::vector<U>*)
+        {
+            s.add("v");
+            add_type_signature(s, static_cast<const U*>(nullptr));
+        }
+
+        template <typename C, typename T> void add_parameter_signature(binary_signature& s, const T& parameter)
+        {
+            if constexpr(is_option<C, T>::value)
+            {
+                s.add("-");
+                s.add(parameter.id);
+            }
+            else
+            {
+                s.add("<");
+                s.add(parameter.short_description);
+            }
+
+            add_type_signature(s, static_cast<const typename T::value_type*>(nullptr));
+        }
+
+        template <typename C, typename... Ts> std::uint64_t compute_binary_signature(const Ts&... parameters)
+        {
+            binary_signature s;
+            (add_parameter_signature<C>(s, parameters), ...);
+            return s.value;
+        }
+
+        //---------------------------------------------------------------------
+
+        struct binary_writer
+        {
+            std::vector<char> records;
+            std::vector<char> arena;
+
+            template <typename T> void put(const T& value)
+            {
+                const auto p = reinterpret_cast<const char*>(&value);
+                records.insert(records.end(), p, p + sizeof(T));
+            }
+        };
+
+        template <typename T> void encode(binary_writer& w, const T& value)
+        {
+            if constexpr(is_binary_string<T>::value)
+            {
+                w.put(static_cast<std::uint32_t>(w.arena.size()));
+                w.put(static_cast<std::uint32_t>(value.size()));
+                w.arena.insert(w.arena.end(), value.begin(), value.end());
+            }
+            else if constexpr(std::is_same_v<T, bool>)
+            {
+                w.put(static_cast<std::uint8_t>(value));
+            }
+            else if constexpr(is_tuple_like<T>::value && !is_binary_trivial<T>)
+            {
+                std::apply([&w](const auto&... c) { (encode(w, c), ...); }, value);
+            }
+            else
+            {
+                static_assert(is_binary_trivial<T>, "this type cannot be stored in a binary configuration");
+                w.put(value);
+            }
+        }
+
+        template <typename U> void encode(binary_writer& w, const std::optional<U>& value)
+        {
+            w.put(static_cast<std::uint8_t>(value.has_value()));
+            if(value) encode(w, *value);
+        }
+
+        template <typename U> void encode(binary_writer& w, const std::vector<U>& values)
+        {
+            w.put(static_cast<std::uint32_t>(values.size()));
+            for(const auto& value : values)
+            {
+                encode(w, value);
+            }
+        }
+
+        //---------------------------------------------------------------------
+
+        struct binary_reader
+        {
+            const char* records;
+            const char* records_end;
+            const char* arena;
+            std::size_t arena_size;
+
+            template <typename T> bool get(T& value) noexcept
+            {
+                if(static_cast<std::size_t>(records_end - records) < sizeof(T)) return false;
+                std::memcpy(&value, records, sizeof(T));
+                records += sizeof(T);
+                return true;
+            }
+        };
+
+        template <typename T> bool decode(binary_reader& r, T& value)
+        {
+            if constexpr(is_binary_string<T>::value)
+            {
+                std::uint32_t offset = 0;
+                std::uint32_t size   = 0;
+                if(!r.get(offset) || !r.get(size)) return false;
+                if(offset > r.arena_size || size > r.arena_size - offset) return false;
+                value.assign(r.arena + offset, size);
+                return true;
+            }
+            else if constexpr(std::is_same_v<T, bool>)
+            {
+                std::uint8_t byte = 0;
+                if(!r.get(byte) || byte > 1) return false;
+                value = byte == 1;
+                return true;
+            }
+            else if constexpr(is_tuple_like<T>::value && !is_binary_trivial<T>)
+            {
+                return std::apply([&r](auto&... c) { return (decode(r, c) && ...); }, value);
+            }
+            else
+            {
+                return r.get(value);
+            }
+        }
+
+        template <typename U> bool decode(binary_reader& r, std::optional<U>& value)
+        {
+            std::uint8_t present = 0;
+            if(!r.get(present) || present > 1) return false;
+
+            if(present == 0)
+            {
+                value.reset();
+                return true;
+            }
+
+            return decode(r, value.emplace());
+        }
+
+        template <typename U> bool decode(binary_reader& r, std::vector<U>& values)
+        {
+            std::uint32_t count = 0;
+            if(!r.get(count)) return false;
+
+            // Every element takes at least one byte, which bounds the reservation for corrupt input
+            if(count > static_cast<std::size_t>(r.records_end - r.records)) return false;
+
+            values.clear();
+            values.reserve(count);
+            for(std::uint32_t i = 0; i < count; ++i)
+            {
+                U value{};
+                if(!decode(r, value)) return false;
+                values.push_back(std::move(value));
+            }
+
+            return true;
+        }
+    } // namespace detail
+
+    // Encodes the parameters of a configuration. The result can be decoded by from_binary with the same parameters.
+    template <typename C, typename... Ts> std::vector<char> to_binary(const C& config, const Ts&... parameters)
+    {
+        static_assert(std::is_same_v<C, typename detail::get_config_type<Ts...>::type>,
+                      "the parameters must describe the configuration type");
+
+        detail::binary_writer w;
+        (detail::encode(w, config.*(parameters.p)), ...);
+
+        const detail::binary_header header{detail::binary_magic,
+                                           detail::binary_version,
+                                           static_cast<std::uint16_t>(sizeof...(Ts)),
+                                           detail::compute_binary_signature<C>(parameters...),
+                                           static_cast<std::uint32_t>(w.records.size()),
+                                           static_cast<std::uint32_t>(w.arena.size())};
+
+        std::vector<char> blob(sizeof(header) + w.records.size() + w.arena.size());
+        std::memcpy(blob.data(), &header, sizeof(header));
+        std::memcpy(blob.data() + sizeof(header), w.records.data(), w.records.size());
+        std::memcpy(blob.data() + sizeof(header) + w.records.size(), w.arena.data(), w.arena.size());
+        return blob;
+    }
+
+    // returns:
+    //  the decoded configuration, or nothing if the blob is truncated, corrupt, of a different version or
+    //  was encoded with a different parameter list
+    template <typename... Ts>
+    auto from_binary(const void* data, std::size_t size, const Ts&... parameters)
+        -> std::optional<typename detail::get_config_type<Ts...>::type>
+    {
+        using ConfigType = typename detail::get_config_type<Ts...>::type;
+
+        detail::binary_header header{};
+        if(size < sizeof(header)) return std::nullopt;
+        std::memcpy(&header, data, sizeof(header));
+
+        if(header.magic != detail::binary_magic || header.version != detail::binary_version ||
+           header.parameter_count != sizeof...(Ts) ||
+           header.signature != detail::compute_binary_signature<ConfigType>(parameters...))
+        {
+            return std::nullopt;
+        }
+
+        if(std::uint64_t{header.records_size} + header.arena_size != size - sizeof(header)) return std::nullopt;
+
+        const auto records = static_cast<const char*>(data) + sizeof(header);
+        detail::binary_reader r{records, records + header.records_size, records + header.records_size,
+                                header.arena_size};
+
+        auto config   = ConfigType{};
+        const auto ok = (detail::decode(r, config.*(parameters.p)) && ...);
+        if(!ok || r.records != r.records_end) return std::nullopt;
+
+        return config;
+    }
+} // namespace bisect::bicla
@@ -0,0 +1,313 @@
+#pragma once
+
+#include "bisect/bicla.h"
+
+#include <cctype>
+#include <fstream>
+
+//------------------------------------------------------------------------------
+// Shell completion scripts and help pages generated from the same parameters as parse, so that they can be
+// produced at build time (see config/cmake/BiclaCompletion.cmake) and never need to run the program itself.
+//------------------------------------------------------------------------------
+
+namespace bisect::bicla
+{
+    namespace detail
+    {
+        template <typename C, typename T> constexpr bool takes_value()
+        {
+            if constexpr(is_option<C, T>::value)
+            {
+                return !std::is_same_v<typename T::value_type, bool>;
+            }
+            else
+            {
+                return false;
+            }
+        }
+
+        // V is the type of a single token
+        template <typename V> constexpr bool completes_files()
+        {
+            return !std::is_arithmetic_v<V>;
+        }
+
+        template <typename V, std::size_t... Is>
+        constexpr std::array<bool, sizeof...(Is)> completes_files(std::index_sequence<Is...>)
+        {
+            return {completes_files<std::tuple_element_t<Is, V>>()...};
+        }
+
+        // For each token of a value, whether it completes from file names: a pair, tuple or array decides per
+        // component
+        template <typename T> constexpr std::array<bool, arity<T>::value> token_completes_files()
+        {
+            using element_type = element_of_t<T>;
+            if constexpr(is_tuple_like<element_type>::value)
+            {
+                return completes_files<element_type>(std::make_index_sequence<arity<T>::value>{});
+            }
+            else
+            {
+                return {completes_files<element_type>()};
+            }
+        }
+
+        template <typename C, typename T> constexpr std::size_t value_arity()
+        {
+            if constexpr(takes_value<C, T>())
+            {
+                return arity<typename T::value_type>::value;
+            }
+            else
+            {
+                return 0;
+            }
+        }
+
+        template <typename T> bool has_choices(const T& parameter)
+        {
+            return parameter.constraints.describe_choices != nullptr;
+        }
+
+        inline std::string completion_function_name(std::string_view program)
+        {
+            std::string name = "_";
+            for(const auto c : program)
+            {
+                name += std::isalnum(static_cast<unsigned char>(c)) ? c : '_';
+            }
+
+            return name;
+        }
+
+        // For a zsh _arguments spec, which is single quoted
+        inline std::string zsh_escape(std::string_view s)
+        {
+            std::string out;
+            for(const auto c : s)
+            {
+                if(c == '\'')
+                {
+                    out += "'\\''";
+                    continue;
+                }
+
+                if(c == '[' || c == ']' || c == ':' || c == '\\') out += '\\';
+                out += c;
+            }
+
+            return out;
+        }
+
+        //---------------------------------------------------------------------
+
+        template <typename C, typename T> void write_bash_option_marker(std::ostream& os, const T& parameter)
+        {
+            if constexpr(is_option<C, T>::value)
+            {
+                os << " -" << parameter.id;
+            }
+        }
+
+        template <typename T> void write_bash_reply(std::ostream& os, const T& parameter, bool files)
+        {
+            if(has_choices(parameter))
+            {
+                os << "COMPREPLY=($(compgen -W \"";
+                parameter.constraints.describe_choices(os, " ");
+                os << "\" -- \"$cur\"))";
+            }
+            else if(files)
+            {
+                os << "COMPREPLY=($(compgen -f -- \"$cur\"))";
+            }
+            else
+            {
+                os << "COMPREPLY=()";
+            }
+        }
+
+        // The first token of a value, right after the option marker
+        template <typename C, typename T> void write_bash_value_case(std::ostream& os, const T& parameter)
+        {
+            if constexpr(takes_value<C, T>())
+            {
+                os << "        \"-" << parameter.id << "\") ";
+                write_bash_reply(os, parameter, token_completes_files<typename T::value_type>()[0]);
+                os << "; return ;;\n";
+            }
+        }
+
+        // The token at index of a multi-token value, found by looking index + 1 words back for the option marker
+        template <typename C, typename T>
+        void write_bash_later_value(std::ostream& os, const T& parameter, std::size_t index)
+        {
+            if constexpr(takes_value<C, T>())
+            {
+                if(index >= value_arity<C, T>()) return;
+
+                os << "    if (( COMP_CWORD > " << index + 1 << " )) && [[ \"${COMP_WORDS[COMP_CWORD-" << index + 1
+                   << "]}\" == \"-" << parameter.id << "\" ]]; then ";
+                write_bash_reply(os, parameter, token_completes_files<typename T::value_type>()[index]);
+                os << "; return; fi\n";
+            }
+        }
+
+        template <typename C, typename T> void write_zsh_spec(std::ostream& os, const T& parameter)
+        {
+            if constexpr(is_rest<C, T>::value)
+            {
+                os << "    '*::" << zsh_escape(parameter.short_description) << ":_normal'";
+            }
+            else if constexpr(is_argument<C, T>::value)
+            {
+                const auto optional = !is_required<C, T>();
+                os << "    '" << (optional ? ":" : "") << ":" << zsh_escape(parameter.short_description) << ":"
+                   << (completes_files<element_of_t<typename T::value_type>>() ? "_files" : " ") << "'";
+            }
+            else if constexpr(is_option<C, T>::value)
+            {
+                using value_type = typename T::value_type;
+
+                const auto repeatable = is_vector<value_type>::value;
+                os << "    '" << (repeatable ? "*" : "") << "-" << zsh_escape(parameter.id) << "["
+                   << zsh_escape(parameter.long_description) << "]";
+
+                if constexpr(takes_value<C, T>())
+                {
+                    constexpr auto files = token_completes_files<value_type>();
+                    for(std::size_t i = 0; i < arity<value_type>::value; ++i)
+                    {
+                        os << ":" << zsh_escape(parameter.short_description) << ":";
+                        if(has_choices(parameter))
+                        {
+                            std::ostringstream choices;
+                            parameter.constraints.describe_choices(choices, " ");
+                            os << "(" << zsh_escape(choices.str()) << ")";
+                        }
+                        else
+                        {
+                            os << (files[i] ? "_files" : " ");
+                        }
+                    }
+                }
+
+                os << "'";
+            }
+
+            os << " \\\n";
+        }
+    } // namespace detail
+
+    template <typename... Ts> void write_help(std::ostream& os, std::string_view program, const Ts&... parameters)
+    {
+        using ConfigType = typename detail::get_config_type<Ts...>::type;
+
+        os << "usage: " << program << ' ' << detail::build_usage_message<ConfigType>(parameters...) << "\n\n";
+        for(const auto& d : detail::build_parameters_description(parameters...))
+        {
+            os << "  " << d << '\n';
+        }
+    }
+
+    // Option values complete from their choices if they have any, from file names otherwise, except for numbers.
+    // Each token of a pair, tuple or array value completes according to its own type.
+    template <typename... Ts>
+    void write_bash_completion(std::ostream& os, std::string_view program, const Ts&... parameters)
+    {
+        using ConfigType    = typename detail::get_config_type<Ts...>::type;
+        const auto function = detail::completion_function_name(program);
+
+        os << "# bash completion for " << program << ", generated by bicla\n\n";
+        os << function << "()\n{\n";
+        os << "    local cur=\"${COMP_WORDS[COMP_CWORD]}\"\n";
+        os << "    local prev=\"${COMP_WORDS[COMP_CWORD-1]}\"\n\n";
+
+        // Later tokens first: like parse, the marker furthest back takes the tokens that follow it
+        constexpr auto max_arity = std::max({std::size_t{1}, detail::value_arity<ConfigType, Ts>()...});
+        std::ostringstream later;
+        for(auto index = max_arity - 1; index > 0; --index)
+        {
+            (detail::write_bash_later_value<ConfigType>(later, parameters, index), ...);
+        }
+        if(!later.str().empty()) os << later.str() << '\n';
+
+        os << "    case \"$prev\" in\n";
+        (detail::write_bash_value_case<ConfigType>(os, parameters), ...);
+        os << "    esac\n\n";
+        os << "    if [[ \"$cur\" == -* ]]; then\n";
+        os << "        COMPREPLY=($(compgen -W \"";
+        std::ostringstream markers;
+        (detail::write_bash_option_marker<ConfigType>(markers, parameters), ...);
+        os << markers.str().substr(markers.str().empty() ? 0 : 1) << "\" -- \"$cur\"))\n";
+        os << "    else\n";
+        os << "        COMPREPLY=($(compgen -f -- \"$cur\"))\n";
+        os << "    fi\n";
+        os << "}\n\n";
+        os << "complete -F " << function << ' ' << program << '\n';
+    }
+
+    template <typename... Ts>
+    void write_zsh_completion(std::ostream& os, std::string_view program, const Ts&... parameters)
+    {
+        using ConfigType = typename detail::get_config_type<Ts...>::type;
+
+        os << "#compdef " << program << "\n";
+        os << "# zsh completion for " << program << ", generated by bicla\n\n";
+        os << "_arguments \\\n";
+        (detail::write_zsh_spec<ConfigType>(os, parameters), ...);
+        os << "    && return 0\n";
+    }
+
+    // The main function of a completion generator, as built by bicla_add_completion:
+    //
+    //  int main(int argc, char* argv[])
+    //  {
+    //      return bisect::bicla::write_completion_files(argc, argv, <the program's parameters>...);
+    //  }
+    //
+    // usage: generator <directory> <program>
+    // writes <directory>/<program>.bash, <directory>/_<program> (zsh) and <directory>/<program>.txt (help)
+    // returns: a process exit code
+    template <typename... Ts> int write_completion_files(int argc, const char* const argv[], const Ts&... parameters)
+    {
+        struct generator_config
+        {
+            std::string directory;
+            std::string program;
+        };
+
+        const auto parsed =
+            parse(argc, argv, argument(&generator_config::directory, "directory", "where to write the files"),
+                  argument(&generator_config::program, "program", "the name of the program to complete"));
+        const auto& result = std::get<0>(parsed);
+        const auto& config = std::get<1>(parsed);
+        if(!result)
+        {
+            std::cerr << result;
+            return 1;
+        }
+
+        const auto write = [&config](const std::string& name, auto writer) {
+            std::ofstream file(config.directory + "/" + name, std::ios::binary);
+            writer(file);
+            return static_cast<bool>(file);
+        };
+
+        const auto ok =
+            write(config.program + ".bash",
+                  [&](std::ostream& os) { write_bash_completion(os, config.program, parameters...); }) &&
+            write("_" + config.program,
+                  [&](std::ostream& os) { write_zsh_completion(os, config.program, parameters...); }) &&
+            write(config.program + ".txt", [&](std::ostream& os) { write_help(os, config.program, parameters...); });
+
+        if(!ok)
+        {
+            std::cerr << "could not write the completion files to " << config.directory << '\n';
+            return 1;
+        }
+
+        return 0;
+    }
+} // namespace bisect::bicla
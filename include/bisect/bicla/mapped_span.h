@@ -0,0 +1,199 @@
+#pragma once
+
+#include "bisect/bicla.h"
+
+#include <cstdint>
+#include <istream>
+#include <string>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//------------------------------------------------------------------------------
+// An option value that is a file of T, mapped read-only instead of being read from argv:
+//
+//  struct config
+//  {
+//      bisect::bicla::mapped_span<const float> weights;
+//  };
+//
+//  auto [result, config] = bicla::parse(argc, argv, bicla::option(&config::weights, "weights", "weights file"));
+//
+// The token is the path of the file, whose size must be a multiple of sizeof(T). The contents are used as they
+// are, in the byte order of the machine, without copying.
+// parse moves the mapping into the parse result, so the span stays valid for as long as the result lives.
+//------------------------------------------------------------------------------
+
+namespace bisect::bicla
+{
+    namespace detail
+    {
+        // A read-only mapping of a whole file, unmapped when destroyed
+        class file_mapping
+        {
+          public:
+            // returns: nullptr if the file cannot be opened or mapped. An empty file has no mapping, as mmap does
+            // not take a length of zero, and gives a null data()
+            static std::shared_ptr<const file_mapping> open(const std::string& path)
+            {
+#if defined(_WIN32)
+                const auto file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                              FILE_ATTRIBUTE_NORMAL, nullptr);
+                if(file == INVALID_HANDLE_VALUE) return nullptr;
+
+                LARGE_INTEGER size;
+                if(!GetFileSizeEx(file, &size) || static_cast<unsigned long long>(size.QuadPart) > SIZE_MAX)
+                {
+                    CloseHandle(file);
+                    return nullptr;
+                }
+
+                if(size.QuadPart == 0)
+                {
+                    CloseHandle(file);
+                    return std::shared_ptr<const file_mapping>(new file_mapping(nullptr, 0));
+                }
+
+                const auto mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                CloseHandle(file);
+                if(mapping == nullptr) return nullptr;
+
+                const auto data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+                CloseHandle(mapping);
+                if(data == nullptr) return nullptr;
+
+                return std::shared_ptr<const file_mapping>(
+                    new file_mapping(data, static_cast<std::size_t>(size.QuadPart)));
+#else
+                const auto fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+                if(fd < 0) return nullptr;
+
+                struct stat st;
+                if(::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))
+                {
+                    ::close(fd);
+                    return nullptr;
+                }
+
+                const auto size = static_cast<std::size_t>(st.st_size);
+                if(size == 0)
+                {
+                    ::close(fd);
+                    return std::shared_ptr<const file_mapping>(new file_mapping(nullptr, 0));
+                }
+
+                const auto data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+                // The mapping keeps its own reference to the file
+                ::close(fd);
+                if(data == MAP_FAILED) return nullptr;
+
+                return std::shared_ptr<const file_mapping>(new file_mapping(data, size));
+#endif
+            }
+
+            file_mapping(const file_mapping&) = delete;
+            file_mapping& operator=(const file_mapping&) = delete;
+
+            ~file_mapping()
+            {
+                if(data_ == nullptr) return;
+
+#if defined(_WIN32)
+                UnmapViewOfFile(data_);
+#else
+                ::munmap(data_, size_);
+#endif
+            }
+
+            const void* data() const noexcept { return data_; }
+            std::size_t size() const noexcept { return size_; }
+
+          private:
+            file_mapping(void* data, std::size_t size) noexcept : data_(data), size_(size) {}
+
+            void* data_;
+            std::size_t size_;
+        };
+    } // namespace detail
+
+    // A view over a file mapped in memory, as an array of T.
+    // Until it is parsed the view owns its mapping; parse then hands the mapping over to the parse result, which
+    // must outlive the view and its copies.
+    template <typename T> class mapped_span
+    {
+        static_assert(std::is_const_v<T>, "files are mapped read-only: use mapped_span<const T>");
+        static_assert(std::is_trivially_copyable_v<T>, "the elements are read from the file as they are");
+
+      public:
+        using element_type   = T;
+        using value_type     = std::remove_cv_t<T>;
+        using const_iterator = T*;
+
+        mapped_span() noexcept = default;
+
+        T* data() const noexcept { return data_; }
+        std::size_t size() const noexcept { return size_; }
+        std::size_t size_bytes() const noexcept { return size_ * sizeof(T); }
+        bool empty() const noexcept { return size_ == 0; }
+
+        const_iterator begin() const noexcept { return data_; }
+        const_iterator end() const noexcept { return data_ + size_; }
+
+        T& operator[](std::size_t i) const noexcept { return data_[i]; }
+
+        // Maps the file at path, replacing the current view. An empty file gives an empty view.
+        // returns false, leaving the view unchanged, if the file cannot be mapped, its size is not a multiple of
+        // sizeof(T) or the mapping is not suitably aligned for T
+        bool map(const std::string& path)
+        {
+            auto mapping = detail::file_mapping::open(path);
+            if(!mapping) return false;
+
+            const auto address = reinterpret_cast<std::uintptr_t>(mapping->data());
+            if(mapping->size() % sizeof(T) != 0 || address % alignof(T) != 0) return false;
+
+            data_    = static_cast<T*>(mapping->data());
+            size_    = mapping->size() / sizeof(T);
+            mapping_ = std::move(mapping);
+            return true;
+        }
+
+        // Gives up the ownership of the mapping: the view stays valid for as long as the returned handle lives
+        std::shared_ptr<const void> release_resource() noexcept { return std::move(mapping_); }
+
+        // Two views are equal if they hold the same values, so that remapping an unchanged file is not a change
+        friend bool operator==(const mapped_span& a, const mapped_span& b) noexcept
+        {
+            if(a.size_ != b.size_) return false;
+            return a.size_ == 0 || a.data_ == b.data_ || std::memcmp(a.data_, b.data_, a.size_bytes()) == 0;
+        }
+
+        friend bool operator!=(const mapped_span& a, const mapped_span& b) noexcept { return !(a == b); }
+
+        // The whole token is the path, spaces included
+        friend std::istream& operator>>(std::istream& is, mapped_span& s)
+        {
+            std::string path;
+            if(std::getline(is, path) && !s.map(path)) is.setstate(std::ios::failbit);
+            return is;
+        }
+
+      private:
+        T* data_          = nullptr;
+        std::size_t size_ = 0;
+        std::shared_ptr<const detail::file_mapping> mapping_;
+    };
+} // namespace bisect::bicla
@@ -0,0 +1,232 @@
+#pragma once
+
+#include "bisect/bicla.h"
+
+#include <cstdint>
+#include <limits>
+
+//------------------------------------------------------------------------------
+// Presets are fixed lists of options parsed at compile time into a constexpr configuration, which can then be
+// used as the starting point of parse:
+//
+//  constexpr auto throughput = bicla::parse_preset(std::array<std::string_view, 4>{"-threads", "64", "-mode", "fast"},
+//                                                  bicla::preset_option(&config::threads, "threads"),
+//                                                  bicla::preset_option(&config::mode, "mode", mode_names));
+//  static_assert(throughput, "invalid preset");
+//
+//  auto [result, config] = bicla::parse(throughput, argc, argv, <runtime parameters>...);
+//
+// A runtime option with the id of an option the preset set is not required: if it is missing from argv, it keeps
+// the preset value, which must still satisfy the option's constraints. Every other parameter is parsed as usual.
+//
+// The runtime parameters hold std::string, which is not a literal type in C++17, so presets are described by
+// preset_option, which only names the option. Values can be integers, enums (by name, through a table, or by
+// underlying value) and std::string_view, which refers to the token. As with parse, a bool is a flag: its marker
+// alone sets it, and it takes no value.
+// A std::string_view member can only be set by the preset: parse copies argv before converting it, so option and
+// argument reject views, which would dangle once parse returns.
+//------------------------------------------------------------------------------
+
+namespace bisect::bicla
+{
+    namespace detail
+    {
+        template <typename C, typename T> struct preset_option
+        {
+            using config_type = C;
+            using value_type  = T;
+
+            T C::*p;
+            std::string_view id;
+
+            // For enums: the name of each value
+            const std::pair<std::string_view, T>* names = nullptr;
+            std::size_t name_count                      = 0;
+        };
+
+        template <typename T> constexpr bool parse_preset_integer(std::string_view s, T& value)
+        {
+            const auto negative = !s.empty() && s[0] == '-';
+            if(negative) s.remove_prefix(1);
+            if(s.empty() || (negative && std::is_unsigned_v<T>)) return false;
+
+            // Accumulate towards the sign, so that the minimum value of T does not overflow
+            T n = 0;
+            for(const auto c : s)
+            {
+                if(c < '0' || c > '9') return false;
+                const auto digit = static_cast<T>(c - '0');
+
+                if(negative)
+                {
+                    if(n < (std::numeric_limits<T>::min() + digit) / 10) return false;
+                    n = static_cast<T>(n * 10 - digit);
+                }
+                else
+                {
+                    if(n > (std::numeric_limits<T>::max() - digit) / 10) return false;
+                    n = static_cast<T>(n * 10 + digit);
+                }
+            }
+
+            value = n;
+            return true;
+        }
+
+        template <typename C, typename T>
+        constexpr bool parse_preset_value(std::string_view s, const preset_option<C, T>& option, T& value)
+        {
+            if constexpr(std::is_same_v<T, std::string_view>)
+            {
+                value = s;
+                return true;
+            }
+            else if constexpr(std::is_enum_v<T>)
+            {
+                for(std::size_t i = 0; i < option.name_count; ++i)
+                {
+                    if(option.names[i].first == s)
+                    {
+                        value = option.names[i].second;
+                        return true;
+                    }
+                }
+
+                std::underlying_type_t<T> n = 0;
+                if(!parse_preset_integer(s, n)) return false;
+                value = static_cast<T>(n);
+                return true;
+            }
+            else
+            {
+                static_assert(std::is_integral_v<T>, "preset values must be integers, enums or string_view");
+                return parse_preset_integer(s, value);
+            }
+        }
+
+        // returns: the number of tokens used, 0 if the option does not match or its value is not valid
+        template <typename C, typename T, std::size_t N>
+        constexpr std::size_t parse_preset_option(C& config, const std::array<std::string_view, N>& tokens,
+                                                  std::size_t i, const preset_option<C, T>& option)
+        {
+            const auto token = tokens[i];
+            if(token.size() != option.id.size() + 1 || token[0] != '-' || token.substr(1) != option.id) return 0;
+
+            if constexpr(std::is_same_v<T, bool>)
+            {
+                config.*(option.p) = true;
+                return 1;
+            }
+            else
+            {
+                if(i + 1 == N) return 0;
+
+                T value{};
+                if(!parse_preset_value(tokens[i + 1], option, value)) return 0;
+                config.*(option.p) = value;
+                return 2;
+            }
+        }
+    } // namespace detail
+
+    // N is the number of preset options
+    template <typename C, std::size_t N> struct preset_result
+    {
+        bool success;
+        C config;
+
+        // The id of each preset option, and the options the preset set: bit i for ids[i]
+        std::array<std::string_view, N> ids;
+        std::uint64_t set;
+
+        constexpr explicit operator bool() const noexcept { return success; }
+
+        constexpr bool is_set(std::string_view id) const noexcept
+        {
+            for(std::size_t i = 0; i < N; ++i)
+            {
+                if(ids[i] == id && ((set >> i) & 1) != 0) return true;
+            }
+
+            return false;
+        }
+    };
+
+    namespace detail
+    {
+        // The runtime options that a preset already set
+        template <typename C, std::size_t N> struct preset_initialized
+        {
+            template <typename T> bool operator()(const T& parameter) const
+            {
+                if constexpr(is_option<C, T>::value)
+                {
+                    return preset.is_set(parameter.id);
+                }
+                else
+                {
+                    return false;
+                }
+            }
+
+            const preset_result<C, N>& preset;
+        };
+    } // namespace detail
+
+    template <typename C, typename T>
+    constexpr detail::preset_option<C, T> preset_option(T C::*_p, std::string_view _id)
+    {
+        return detail::preset_option<C, T>{_p, _id, nullptr, 0};
+    }
+
+    // An enum option whose values are given by name, as listed in a table with static storage
+    template <typename C, typename T, std::size_t N>
+    constexpr detail::preset_option<C, T> preset_option(T C::*_p, std::string_view _id,
+                                                        const std::array<std::pair<std::string_view, T>, N>& _names)
+    {
+        return detail::preset_option<C, T>{_p, _id, _names.data(), N};
+    }
+
+    // Parses a fixed list of options; meant to be evaluated at compile time.
+    // returns: success is false if a token is not one of the options, or is not followed by a valid value
+    template <std::size_t N, typename... Ts>
+    constexpr auto parse_preset(const std::array<std::string_view, N>& tokens, const Ts&... options)
+        -> preset_result<typename detail::get_config_type<Ts...>::type, sizeof...(Ts)>
+    {
+        using ConfigType = typename detail::get_config_type<Ts...>::type;
+
+        static_assert(sizeof...(Ts) <= 64, "a preset can have at most 64 options");
+
+        const std::array<std::string_view, sizeof...(Ts)> ids{options.id...};
+        std::uint64_t set = 0;
+
+        auto config = ConfigType{};
+        for(std::size_t i = 0; i < N;)
+        {
+            // k ends one past the option that matched
+            std::size_t used = 0;
+            std::size_t k    = 0;
+            static_cast<void>(
+                ((++k, (used = detail::parse_preset_option(config, tokens, i, options)) != 0) || ...));
+            if(used == 0) return {false, config, ids, set};
+
+            set |= std::uint64_t{1} << (k - 1);
+            i += used;
+        }
+
+        return {true, config, ids, set};
+    }
+
+    // Same as parse, but starts from the configuration of a preset. The options that the preset set are not
+    // required, and keep their preset values when they are not on the command line.
+    template <typename C, std::size_t N, typename... Ts>
+    auto parse(const preset_result<C, N>& preset, int argc, const char* const argv[], const Ts&... options)
+        -> std::tuple<parse_result, C>
+    {
+        static_assert(std::is_same_v<C, typename detail::get_config_type<Ts...>::type>,
+                      "the preset and the parameters must describe the same configuration type");
+
+        return detail::parse_with(std::allocator<char>(), preset.config, detail::preset_initialized<C, N>{preset},
+                                  detail::unobserved{}, argc, argv, options...);
+    }
+} // namespace bisect::bicla
@@ -0,0 +1,180 @@
+#pragma once
+
+#include "bisect/bicla.h"
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+//------------------------------------------------------------------------------
+// Usage profiles count, over many runs, how often each parameter is used and how long parse spends on it:
+//
+//  bisect::bicla::usage_profile profile;
+//  profile.merge("program.profile");
+//  auto [result, config] = bisect::bicla::parse(profile, argc, argv, <parameters>...);
+//  profile.save("program.profile");
+//
+// bicla_add_dispatch_order, in config/cmake/BiclaProfile.cmake, turns a saved profile into a header listing the
+// most used option ids, to be given to incremental_parser::prefer.
+//
+// A saved profile is a text file:
+//
+//  bicla-profile 1 <parses>
+//  <hits> <nanoseconds> <parameter>
+//  ...
+//
+// with one line per parameter, most used first. Counts are written with 20 digits so that the lines also sort
+// as text. Parameters are named "-id" for options and "<short description>" for arguments; a rest parameter is
+// not matched token by token, so it is not profiled.
+//------------------------------------------------------------------------------
+
+namespace bisect::bicla
+{
+    class usage_profile;
+
+    namespace detail
+    {
+        template <typename C, typename T> std::string profile_name(const T& parameter)
+        {
+            if constexpr(is_option<C, T>::value)
+            {
+                return "-" + parameter.id;
+            }
+            else
+            {
+                return "<" + parameter.short_description + ">";
+            }
+        }
+
+        struct profiler
+        {
+            template <typename T, typename V, typename F> bool operator()(const T& parameter, const V& args, F&& pass);
+
+            usage_profile& profile;
+        };
+    } // namespace detail
+
+    class usage_profile
+    {
+      public:
+        struct entry
+        {
+            std::string parameter;
+
+            // The number of parses that used the parameter, and the time spent matching its tokens over all parses
+            std::uint64_t hits        = 0;
+            std::uint64_t nanoseconds = 0;
+        };
+
+        std::uint64_t parses() const noexcept { return parses_; }
+
+        // One entry per parameter seen so far, in the order they were first seen
+        const std::vector<entry>& entries() const noexcept { return entries_; }
+
+        // Adds the counts saved in a file, so that a profile can build up over many runs.
+        // returns false, leaving the profile unchanged, if the file cannot be read or is not a profile
+        bool merge(const std::string& path)
+        {
+            std::ifstream in(path);
+            std::string magic;
+            int version          = 0;
+            std::uint64_t parses = 0;
+            if(!(in >> magic >> version >> parses) || magic != "bicla-profile" || version != 1) return false;
+
+            std::vector<entry> saved;
+            entry e;
+            while(in >> e.hits >> e.nanoseconds && std::getline(in >> std::ws, e.parameter))
+            {
+                saved.push_back(e);
+            }
+            if(!in.eof()) return false;
+
+            parses_ += parses;
+            for(const auto& s : saved)
+            {
+                auto& target = find(s.parameter);
+                target.hits += s.hits;
+                target.nanoseconds += s.nanoseconds;
+            }
+
+            return true;
+        }
+
+        // Writes the profile, most used parameters first.
+        // returns false if the file cannot be written
+        bool save(const std::string& path) const
+        {
+            auto sorted = entries_;
+            std::stable_sort(sorted.begin(), sorted.end(),
+                             [](const entry& a, const entry& b) { return a.hits > b.hits; });
+
+            std::ofstream out(path);
+            out << "bicla-profile 1 " << parses_ << '\n';
+            out.fill('0');
+            for(const auto& e : sorted)
+            {
+                out.width(20);
+                out << e.hits << ' ';
+                out.width(20);
+                out << e.nanoseconds << ' ' << e.parameter << '\n';
+            }
+
+            return static_cast<bool>(out.flush());
+        }
+
+      private:
+        friend struct detail::profiler;
+
+        template <typename... Ts>
+        friend auto parse(usage_profile& profile, int argc, const char* const argv[], const Ts&... options)
+            -> std::tuple<parse_result, typename detail::get_config_type<Ts...>::type>;
+
+        entry& find(const std::string& parameter)
+        {
+            for(auto& e : entries_)
+            {
+                if(e.parameter == parameter) return e;
+            }
+
+            auto& e     = entries_.emplace_back();
+            e.parameter = parameter;
+            return e;
+        }
+
+        std::uint64_t parses_ = 0;
+        std::vector<entry> entries_;
+    };
+
+    namespace detail
+    {
+        // A parameter is hit when its pass consumes tokens
+        template <typename T, typename V, typename F>
+        bool profiler::operator()(const T& parameter, const V& args, F&& pass)
+        {
+            if constexpr(is_rest<typename T::config_type, T>::value) return pass();
+
+            const auto size  = args.size();
+            const auto start = std::chrono::steady_clock::now();
+            const auto ok    = pass();
+            const auto stop  = std::chrono::steady_clock::now();
+
+            auto& e = profile.find(profile_name<typename T::config_type>(parameter));
+            if(args.size() != size) ++e.hits;
+            e.nanoseconds += static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count());
+
+            return ok;
+        }
+    } // namespace detail
+
+    // Same as parse, and also counts, in profile, the parameters used and the time spent matching each of them
+    template <typename... Ts>
+    auto parse(usage_profile& profile, int argc, const char* const argv[], const Ts&... options)
+        -> std::tuple<parse_result, typename detail::get_config_type<Ts...>::type>
+    {
+        ++profile.parses_;
+        return detail::parse_with(std::allocator<char>(), {}, detail::uninitialized{}, detail::profiler{profile}, argc,
+                                  argv, options...);
+    }
+} // namespace bisect::bicla
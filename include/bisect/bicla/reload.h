@@ -0,0 +1,133 @@
+#pragma once
+
+#include "bisect/bicla.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+//------------------------------------------------------------------------------
+
+namespace bisect::bicla
+{
+    namespace detail
+    {
+        template <typename C, typename T>
+        void do_diff(std::vector<bool>& changed, const C& before, const C& after, const T& parameter)
+        {
+            changed.push_back(!(before.*(parameter.p) == after.*(parameter.p)));
+        }
+
+        template <typename C, typename T, typename... Ts>
+        void do_diff(std::vector<bool>& changed, const C& before, const C& after, const T& parameter,
+                     const Ts&... other)
+        {
+            do_diff(changed, before, after, parameter);
+            do_diff(changed, before, after, other...);
+        }
+    } // namespace detail
+
+    // returns, for each parameter and in the same order, whether its value differs between the two configurations
+    template <typename C, typename... Ts>
+    std::vector<bool> diff(const C& before, const C& after, const Ts&... parameters)
+    {
+        std::vector<bool> changed;
+        changed.reserve(sizeof...(Ts));
+        detail::do_diff(changed, before, after, parameters...);
+        return changed;
+    }
+
+    struct reload_result
+    {
+        const parse_result result;
+
+        // one entry per parameter, in the order they were given to reload.
+        // all false if parsing did not succeed.
+        const std::vector<bool> changed;
+
+        bool any_changed() const noexcept
+        {
+            for(const auto c : changed)
+            {
+                if(c) return true;
+            }
+
+            return false;
+        }
+
+        explicit operator bool() const noexcept { return static_cast<bool>(result); }
+    };
+
+    // Holds the current configuration of a long-running process.
+    // Readers call load() and keep the returned snapshot for as long as they need it; this never blocks.
+    // reload() parses into a fresh snapshot and publishes it only if parsing succeeded and something changed,
+    // so comparing the pointers returned by two calls to load() tells whether a new configuration was published.
+    // reload() takes no rest parameter: its argv_span would point into an argv that readers can outlive.
+    template <typename C> class config_snapshot
+    {
+      public:
+        using config_type = C;
+
+        explicit config_snapshot(C initial = C{}) : current_(std::make_shared<const C>(std::move(initial))) {}
+
+        config_snapshot(const config_snapshot&) = delete;
+        config_snapshot& operator=(const config_snapshot&) = delete;
+
+        std::shared_ptr<const C> load() const noexcept
+        {
+#if defined(__cpp_lib_atomic_shared_ptr)
+            return current_.load(std::memory_order_acquire);
+#else
+            return std::atomic_load_explicit(&current_, std::memory_order_acquire);
+#endif
+        }
+
+        template <typename... Ts> reload_result reload(int argc, const char* const argv[], Ts... options)
+        {
+            static_assert(std::is_same_v<C, typename detail::get_config_type<Ts...>::type>,
+                          "the parameters must describe the snapshot's configuration type");
+            static_assert(!detail::has_rest<C, Ts...>,
+                          "a rest parameter views the reload argv, which does not live as long as the snapshot");
+
+            auto [result, config] = parse(argc, argv, options...);
+
+            if(!result)
+            {
+                return {std::move(result), std::vector<bool>(sizeof...(Ts), false)};
+            }
+
+            const std::lock_guard<std::mutex> lock(writer_mutex_);
+
+            const auto previous = load();
+            auto changed        = diff(*previous, config, options...);
+
+            if(std::find(changed.begin(), changed.end(), true) != changed.end())
+            {
+                // The snapshot shares whatever the configuration refers to, such as the files mapped for it
+                const auto owner = std::make_shared<const std::pair<C, parse_result::resource_vector>>(
+                    std::move(config), result.resources);
+                publish(std::shared_ptr<const C>(owner, &owner->first));
+            }
+
+            return {std::move(result), std::move(changed)};
+        }
+
+      private:
+        void publish(std::shared_ptr<const C> next) noexcept
+        {
+#if defined(__cpp_lib_atomic_shared_ptr)
+            current_.store(std::move(next), std::memory_order_release);
+#else
+            std::atomic_store_explicit(&current_, std::move(next), std::memory_order_release);
+#endif
+        }
+
+#if defined(__cpp_lib_atomic_shared_ptr)
+        std::atomic<std::shared_ptr<const C>> current_;
+#else
+        std::shared_ptr<const C> current_;
+#endif
+        std::mutex writer_mutex_;
+    };
+} // namespace bisect::bicla
@@ -0,0 +1,144 @@
+#include "bisect/bicla/binary.h"
+
+#include <array>
+#pragma warning(push)
+#pragma warning(disable : 4996)
+#include "catch2/catch.hpp"
+#pragma warning(pop)
+using namespace bisect::bicla;
+
+//------------------------------------------------------------------------------
+
+namespace
+{
+    enum class mode
+    {
+        fast,
+        safe
+    };
+
+    struct config
+    {
+        std::string name;
+        int threads  = 0;
+        double ratio = 0;
+        bool verbose = false;
+        mode m       = mode::fast;
+        std::optional<std::string> log;
+        std::optional<int> limit;
+        std::vector<std::string> include;
+        std::vector<bool> flags;
+        std::pair<std::string, int> endpoint;
+        std::array<bool, 2> lanes{};
+    };
+
+    template <typename... Ts> auto parameters(Ts&&... extra)
+    {
+        return std::make_tuple(argument(&config::name, "name"), option(&config::threads, "t", "threads"),
+                               option(&config::ratio, "r", "ratio"), option(&config::verbose, "v", "verbose"),
+                               option(&config::m, "m", "mode"), option(&config::log, "l", "log"),
+                               option(&config::limit, "n", "limit"), option(&config::include, "I", "include"),
+                               option(&config::flags, "f", "flags"), option(&config::endpoint, "e", "endpoint"),
+                               std::forward<Ts>(extra)...);
+    }
+} // namespace
+
+SCENARIO("binary configuration")
+{
+    GIVEN("a configuration")
+    {
+        config c;
+        c.name     = "worker";
+        c.threads  = 8;
+        c.ratio    = 0.25;
+        c.verbose  = true;
+        c.m        = mode::safe;
+        c.limit    = 100;
+        c.include  = {"a", "", "a much longer string that does not fit in the small buffer"};
+        c.flags    = {true, false, true};
+        c.endpoint = {"host", 80};
+
+        const auto blob = std::apply([&](const auto&... p) { return to_binary(c, p...); }, parameters());
+
+        WHEN("we decode it with the same parameters")
+        {
+            const auto decoded =
+                std::apply([&](const auto&... p) { return from_binary(blob.data(), blob.size(), p...); }, parameters());
+
+            THEN("we get the same configuration back")
+            {
+                REQUIRE(decoded.has_value());
+                REQUIRE(decoded->name == c.name);
+                REQUIRE(decoded->threads == c.threads);
+                REQUIRE(decoded->ratio == c.ratio);
+                REQUIRE(decoded->verbose == c.verbose);
+                REQUIRE(decoded->m == c.m);
+                REQUIRE(decoded->log == c.log);
+                REQUIRE(decoded->limit == c.limit);
+                REQUIRE(decoded->include == c.include);
+                REQUIRE(decoded->flags == c.flags);
+                REQUIRE(decoded->endpoint == c.endpoint);
+            }
+        }
+
+        WHEN("we decode it with a different parameter list")
+        {
+            const auto decoded = std::apply(
+                [&](const auto&... p) { return from_binary(blob.data(), blob.size(), p...); },
+                parameters(option(&config::log, "log", "log")));
+
+            THEN("it is rejected")
+            {
+                REQUIRE(!decoded.has_value());
+            }
+        }
+
+        WHEN("the blob is truncated")
+        {
+            THEN("it is rejected")
+            {
+                for(std::size_t size = 0; size < blob.size(); ++size)
+                {
+                    const auto decode = [&](const auto&... p) { return from_binary(blob.data(), size, p...); };
+                    REQUIRE(!std::apply(decode, parameters()).has_value());
+                }
+            }
+        }
+    }
+
+    GIVEN("a blob of bools")
+    {
+        config c;
+        c.verbose = true;
+        c.lanes   = {false, true};
+
+        const auto verbose = option(&config::verbose, "v", "verbose");
+        const auto lanes   = option(&config::lanes, "lanes", "lanes");
+        auto blob          = to_binary(c, verbose, lanes);
+
+        WHEN("we decode it")
+        {
+            const auto decoded = from_binary(blob.data(), blob.size(), verbose, lanes);
+
+            THEN("we get the same bools back")
+            {
+                REQUIRE(decoded.has_value());
+                REQUIRE(decoded->verbose == c.verbose);
+                REQUIRE(decoded->lanes == c.lanes);
+            }
+        }
+
+        WHEN("a bool holds a byte other than 0 or 1")
+        {
+            THEN("it is rejected")
+            {
+                for(std::size_t i = 0; i < 3; ++i)
+                {
+                    auto corrupt                               = blob;
+                    corrupt[sizeof(detail::binary_header) + i] = 2;
+                    REQUIRE(!from_binary(corrupt.data(), corrupt.size(), verbose, lanes).has_value());
+                }
+            }
+        }
+    }
+}
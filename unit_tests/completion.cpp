@@ -0,0 +1,138 @@
+#include "bisect/bicla/completion.h"
+
+#pragma warning(push)
+#pragma warning(disable : 4996)
+#include "catch2/catch.hpp"
+#pragma warning(pop)
+using namespace bisect::bicla;
+
+//------------------------------------------------------------------------------
+
+namespace
+{
+    static constexpr std::array<std::string_view, 2> modes{"fast", "safe"};
+
+    struct config
+    {
+        std::string input;
+        std::optional<std::string> output;
+        int threads = 0;
+        std::string mode;
+        bool verbose = false;
+        std::vector<std::string> include;
+        std::pair<std::string, int> endpoint;
+        std::array<double, 2> window{};
+    };
+
+    template <typename F> std::string generate(F f)
+    {
+        std::ostringstream os;
+        f(os, "my-tool", argument(&config::input, "input", "the input file"), argument(&config::output, "output"),
+          option(&config::threads, "t", "threads", "the number of threads"),
+          option(&config::mode, "mode", "mode", "how to run [fast or safe]").choices<modes>(),
+          option(&config::verbose, "v", "verbose", "be verbose"), option(&config::include, "I", "dir", "include"));
+        return os.str();
+    }
+
+    template <typename F> std::string generate_multi_value(F f)
+    {
+        std::ostringstream os;
+        f(os, "my-tool", option(&config::endpoint, "e", "endpoint", "where to connect"),
+          option(&config::window, "w", "window", "the time window"));
+        return os.str();
+    }
+} // namespace
+
+SCENARIO("completion and help generation")
+{
+    GIVEN("a set of parameters")
+    {
+        WHEN("we generate the help page")
+        {
+            const auto help = generate([](auto&&... a) { write_help(a...); });
+
+            THEN("it is correct")
+            {
+                REQUIRE(help == "usage: my-tool <input> [<output>] -t <threads> -mode <mode> [-v <verbose>] "
+                                "[-I <dir>]\n"
+                                "\n"
+                                "  input: the input file\n"
+                                "  output: output\n"
+                                "  threads: the number of threads\n"
+                                "  mode: how to run [fast or safe]\n"
+                                "  verbose: be verbose\n"
+                                "  dir: include\n");
+            }
+        }
+
+        WHEN("we generate the bash completion")
+        {
+            const auto script = generate([](auto&&... a) { write_bash_completion(a...); });
+
+            THEN("it completes option markers and values")
+            {
+                REQUIRE(script.find("_my_tool()\n") != std::string::npos);
+                REQUIRE(script.find("\"-t\") COMPREPLY=(); return ;;\n") != std::string::npos);
+                REQUIRE(script.find("\"-mode\") COMPREPLY=($(compgen -W \"fast safe\" -- \"$cur\")); return ;;\n") !=
+                        std::string::npos);
+                REQUIRE(script.find("\"-I\") COMPREPLY=($(compgen -f -- \"$cur\")); return ;;\n") != std::string::npos);
+                REQUIRE(script.find("\"-v\")") == std::string::npos);
+                REQUIRE(script.find("compgen -W \"-t -mode -v -I\"") != std::string::npos);
+                REQUIRE(script.find("complete -F _my_tool my-tool\n") != std::string::npos);
+            }
+        }
+
+        WHEN("we generate the zsh completion")
+        {
+            const auto script = generate([](auto&&... a) { write_zsh_completion(a...); });
+
+            THEN("it describes every parameter")
+            {
+                REQUIRE(script == "#compdef my-tool\n"
+                                  "# zsh completion for my-tool, generated by bicla\n"
+                                  "\n"
+                                  "_arguments \\\n"
+                                  "    ':input:_files' \\\n"
+                                  "    '::output:_files' \\\n"
+                                  "    '-t[the number of threads]:threads: ' \\\n"
+                                  "    '-mode[how to run \\[fast or safe\\]]:mode:(fast safe)' \\\n"
+                                  "    '-v[be verbose]' \\\n"
+                                  "    '*-I[include]:dir:_files' \\\n"
+                                  "    && return 0\n");
+            }
+        }
+    }
+    GIVEN("options that take several values")
+    {
+        WHEN("we generate the bash completion")
+        {
+            const auto script = generate_multi_value([](auto&&... a) { write_bash_completion(a...); });
+
+            THEN("each value token completes according to its own type")
+            {
+                REQUIRE(script.find("    if (( COMP_CWORD > 2 )) && [[ \"${COMP_WORDS[COMP_CWORD-2]}\" == \"-e\" ]]; "
+                                    "then COMPREPLY=(); return; fi\n") != std::string::npos);
+                REQUIRE(script.find("    if (( COMP_CWORD > 2 )) && [[ \"${COMP_WORDS[COMP_CWORD-2]}\" == \"-w\" ]]; "
+                                    "then COMPREPLY=(); return; fi\n") != std::string::npos);
+                REQUIRE(script.find("\"-e\") COMPREPLY=($(compgen -f -- \"$cur\")); return ;;\n") != std::string::npos);
+                REQUIRE(script.find("\"-w\") COMPREPLY=(); return ;;\n") != std::string::npos);
+            }
+        }
+
+        WHEN("we generate the zsh completion")
+        {
+            const auto script = generate_multi_value([](auto&&... a) { write_zsh_completion(a...); });
+
+            THEN("each value token completes according to its own type")
+            {
+                REQUIRE(script == "#compdef my-tool\n"
+                                  "# zsh completion for my-tool, generated by bicla\n"
+                                  "\n"
+                                  "_arguments \\\n"
+                                  "    '-e[where to connect]:endpoint:_files:endpoint: ' \\\n"
+                                  "    '-w[the time window]:window: :window: ' \\\n"
+                                  "    && return 0\n");
+            }
+        }
+    }
+}
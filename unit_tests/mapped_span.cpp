@@ -0,0 +1,133 @@
+#include "bisect/bicla/mapped_span.h"
+
+#include <array>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#pragma warning(push)
+#pragma warning(disable : 4996)
+#include "catch2/catch.hpp"
+#pragma warning(pop)
+using namespace bisect::bicla;
+
+//------------------------------------------------------------------------------
+
+namespace
+{
+    struct config
+    {
+        mapped_span<const std::uint32_t> ids;
+        std::optional<mapped_span<const double>> weights;
+    };
+
+    // A file in the temporary directory, removed when the test is done
+    class temporary_file
+    {
+      public:
+        temporary_file(const std::string& name, const void* data, std::size_t size)
+            : path_((std::filesystem::temp_directory_path() / name).string())
+        {
+            std::ofstream file(path_, std::ios::binary);
+            file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        }
+
+        ~temporary_file() { std::remove(path_.c_str()); }
+
+        const std::string& path() const noexcept { return path_; }
+
+      private:
+        std::string path_;
+    };
+
+    template <std::size_t N> auto parse_files(const std::array<const char*, N>& argv)
+    {
+        return parse(static_cast<int>(N), argv.data(), option(&config::ids, "ids", "ids file"),
+                     option(&config::weights, "weights", "weights file"));
+    }
+} // namespace
+
+SCENARIO("memory-mapped options")
+{
+    const std::array<std::uint32_t, 4> ids = {1, 2, 3, 4000000000u};
+    const std::array<double, 2> weights    = {0.5, -2};
+    const temporary_file ids_file("bicla ids.bin", ids.data(), sizeof(ids));
+    const temporary_file weights_file("bicla_weights.bin", weights.data(), sizeof(weights));
+    const temporary_file odd_file("bicla_odd.bin", ids.data(), 6);
+    const temporary_file empty_file("bicla_empty.bin", ids.data(), 0);
+
+    GIVEN("files whose size is a multiple of the element size")
+    {
+        const std::array<const char*, 5> argv = {"program name", "-ids", ids_file.path().c_str(), "-weights",
+                                                 weights_file.path().c_str()};
+
+        WHEN("we parse them")
+        {
+            const auto [parse_result, c] = parse_files(argv);
+
+            THEN("the configuration views their contents")
+            {
+                REQUIRE(static_cast<bool>(parse_result));
+                REQUIRE(std::equal(c.ids.begin(), c.ids.end(), ids.begin(), ids.end()));
+                REQUIRE(c.weights.has_value());
+                REQUIRE(std::equal(c.weights->begin(), c.weights->end(), weights.begin(), weights.end()));
+            }
+
+            THEN("the parse result owns the mappings")
+            {
+                REQUIRE(parse_result.resources.size() == 2);
+
+                auto copy = c.ids;
+                REQUIRE(!copy.release_resource());
+            }
+        }
+    }
+
+    GIVEN("an empty file")
+    {
+        const std::array<const char*, 3> argv = {"program name", "-ids", empty_file.path().c_str()};
+
+        WHEN("we parse it")
+        {
+            const auto [parse_result, c] = parse_files(argv);
+
+            THEN("the view is empty")
+            {
+                REQUIRE(static_cast<bool>(parse_result));
+                REQUIRE(c.ids.empty());
+            }
+        }
+    }
+
+    GIVEN("a file whose size is not a multiple of the element size")
+    {
+        const std::array<const char*, 3> argv = {"program name", "-ids", odd_file.path().c_str()};
+
+        WHEN("we parse it")
+        {
+            const auto [parse_result, c] = parse_files(argv);
+
+            THEN("it is rejected")
+            {
+                REQUIRE(!parse_result);
+                REQUIRE(parse_result.errors.size() == 1);
+                REQUIRE(c.ids.empty());
+            }
+        }
+    }
+
+    GIVEN("a file that does not exist")
+    {
+        const std::array<const char*, 3> argv = {"program name", "-ids", "bicla_missing.bin"};
+
+        WHEN("we parse it")
+        {
+            const auto [parse_result, c] = parse_files(argv);
+
+            THEN("it is rejected")
+            {
+                REQUIRE(!parse_result);
+                REQUIRE(parse_result.errors.size() == 1);
+            }
+        }
+    }
+}
@@ -547,4 +547,730 @@ SCENARIO("option and argument parsing")
             }
         }
     }
-}
\ No newline at end of file
+}
+
+SCENARIO("rest parsing")
+{
+    GIVEN("a config with 1 option and a rest parameter")
+    {
+        struct config
+        {
+            int cpus = 0;
+            argv_span command;
+        };
+
+        const auto do_parse = [](const auto& argv) {
+            return parse(int(static_cast<int>(argv.size()) - 1), argv.data(), option(&config::cpus, "cpus", "cpus"),
+                         rest(&config::command, "command"));
+        };
+
+        WHEN("we provide a command after the separator")
+        {
+            const std::array<const char*, 8> argv = {"program name", "-cpus", "4",  "--",
+                                                     "real_binary",  "-cpus", "--", nullptr};
+
+            THEN("the tail refers to the original argv and is null terminated")
+            {
+                const auto [parse_result, config] = do_parse(argv);
+
+                REQUIRE(parse_result == true);
+                REQUIRE(config.cpus == 4);
+                REQUIRE(config.command.size() == 3);
+                REQUIRE(config.command.data() == argv.data() + 4);
+                REQUIRE(std::string(config.command[1]) == "-cpus");
+                REQUIRE(config.command.data()[config.command.size()] == nullptr);
+            }
+        }
+
+        WHEN("we do not provide the separator")
+        {
+            const std::array<const char*, 4> argv = {"program name", "-cpus", "4", nullptr};
+
+            THEN("the tail is empty")
+            {
+                const auto [parse_result, config] = do_parse(argv);
+
+                REQUIRE(parse_result == true);
+                REQUIRE(config.command.empty());
+            }
+        }
+
+        WHEN("we provide extra arguments before the separator")
+        {
+            const std::array<const char*, 6> argv = {"program name", "-cpus", "4", "extra", "--", nullptr};
+
+            THEN("parsing fails")
+            {
+                const auto [parse_result, _] = do_parse(argv);
+                static_cast<void>(_);
+
+                REQUIRE(parse_result == false);
+            }
+        }
+
+        WHEN("we parse")
+        {
+            const std::array<const char*, 2> argv = {"program name", nullptr};
+
+            THEN("the usage message is correct")
+            {
+                const auto [parse_result, _] = do_parse(argv);
+                static_cast<void>(_);
+
+                REQUIRE(parse_result.usage_message == "-cpus <cpus> [-- <command>...]");
+            }
+        }
+    }
+
+    GIVEN("a config with a string option and a rest parameter")
+    {
+        struct config
+        {
+            std::string s;
+            argv_span command;
+        };
+
+        WHEN("the option's value is the separator")
+        {
+            const std::array<const char*, 6> argv = {"program name", "-s", "--", "--", "x", nullptr};
+
+            THEN("it is taken as the value, and the next separator starts the tail")
+            {
+                const auto [parse_result, config] =
+                    parse(static_cast<int>(argv.size()) - 1, argv.data(), option(&config::s, "s", "s"),
+                          rest(&config::command, "command"));
+
+                REQUIRE(parse_result == true);
+                REQUIRE(config.s == "--");
+                REQUIRE(config.command.size() == 1);
+                REQUIRE(std::string(config.command[0]) == "x");
+            }
+        }
+    }
+}
+
+SCENARIO("command line rendering")
+{
+    GIVEN("a parsed config with options, arguments and a rest parameter")
+    {
+        struct config
+        {
+            std::string s;
+            int i      = 0;
+            double d   = 0;
+            bool b     = false;
+            bool c     = false;
+            std::optional<float> f;
+            std::optional<int> n;
+            std::vector<std::string> e;
+            argv_span command;
+        };
+
+        const auto do_parse = [](int argc, const char* const* argv) {
+            return parse(argc, argv, option(&config::i, "i", "i"), option(&config::d, "d", "d"),
+                         option(&config::b, "b", "b"), option(&config::c, "c", "c"), option(&config::f, "f", "f"),
+                         option(&config::n, "n", "n"), option(&config::e, "e", "e"), argument(&config::s, "s"),
+                         rest(&config::command, "command"));
+        };
+
+        const std::array<const char*, 16> argv = {"program name", "-d", "0.1", "string 1", "-i", "-42", "-b", "-f",
+                                                  "1e-7", "-e", "e1", "-e", "e2", "--", "tail", nullptr};
+        const auto [parse_result, original] = do_parse(static_cast<int>(argv.size()) - 1, argv.data());
+        REQUIRE(parse_result == true);
+
+        WHEN("we render it")
+        {
+            const auto rendered =
+                to_argv("worker", original, option(&config::i, "i", "i"), option(&config::d, "d", "d"),
+                        option(&config::b, "b", "b"), option(&config::c, "c", "c"), option(&config::f, "f", "f"),
+                        option(&config::n, "n", "n"), option(&config::e, "e", "e"), argument(&config::s, "s"),
+                        rest(&config::command, "command"));
+
+            THEN("the command line is correct and null terminated")
+            {
+                const auto expected = std::vector<std::string>{"worker", "-i", "-42", "-d", "0.1", "-b", "-f", "1e-07",
+                                                               "-e",     "e1", "-e",  "e2", "string 1", "--", "tail"};
+                REQUIRE(rendered.argc() == static_cast<int>(expected.size()));
+                REQUIRE(std::vector<std::string>(rendered.argv(), rendered.argv() + rendered.argc()) == expected);
+                REQUIRE(rendered.argv()[rendered.argc()] == nullptr);
+            }
+
+            THEN("parsing it yields the same config")
+            {
+                const auto [reparse_result, reparsed] = do_parse(rendered.argc(), rendered.argv());
+
+                REQUIRE(reparse_result == true);
+                REQUIRE(reparsed.s == original.s);
+                REQUIRE(reparsed.i == original.i);
+                REQUIRE(reparsed.d == original.d);
+                REQUIRE(reparsed.b == original.b);
+                REQUIRE(reparsed.c == original.c);
+                REQUIRE(reparsed.f == original.f);
+                REQUIRE(reparsed.n == original.n);
+                REQUIRE(reparsed.e == original.e);
+                REQUIRE(reparsed.command.size() == 1);
+                REQUIRE(std::string(reparsed.command[0]) == "tail");
+            }
+        }
+    }
+
+    GIVEN("a config whose rest parameter comes before an option")
+    {
+        struct config
+        {
+            argv_span command;
+            int i = 0;
+        };
+
+        const auto do_parse = [](int argc, const char* const* argv) {
+            return parse(argc, argv, rest(&config::command, "command"), option(&config::i, "i", "i"));
+        };
+
+        const std::array<const char*, 6> argv = {"program name", "-i", "5", "--", "x", nullptr};
+        const auto [parse_result, original] = do_parse(static_cast<int>(argv.size()) - 1, argv.data());
+        REQUIRE(parse_result == true);
+
+        WHEN("we render it")
+        {
+            const auto rendered =
+                to_argv("worker", original, rest(&config::command, "command"), option(&config::i, "i", "i"));
+
+            THEN("the tail is rendered last and parsing it yields the same config")
+            {
+                const auto expected = std::vector<std::string>{"worker", "-i", "5", "--", "x"};
+                REQUIRE(std::vector<std::string>(rendered.argv(), rendered.argv() + rendered.argc()) == expected);
+
+                const auto [reparse_result, reparsed] = do_parse(rendered.argc(), rendered.argv());
+                REQUIRE(reparse_result == true);
+                REQUIRE(reparsed.i == original.i);
+                REQUIRE(reparsed.command.size() == 1);
+                REQUIRE(std::string(reparsed.command[0]) == "x");
+            }
+        }
+    }
+
+    GIVEN("a parsed config with character options")
+    {
+        struct config
+        {
+            char c           = 0;
+            signed char sc   = 0;
+            unsigned char uc = 0;
+        };
+
+        const auto do_parse = [](int argc, const char* const* argv) {
+            return parse(argc, argv, option(&config::c, "c", "c"), option(&config::sc, "s", "s"),
+                         option(&config::uc, "u", "u"));
+        };
+
+        const std::array<const char*, 7> argv = {"program name", "-c", "x", "-s", "y", "-u", "z"};
+        const auto [parse_result, original] = do_parse(static_cast<int>(argv.size()), argv.data());
+        REQUIRE(parse_result == true);
+        REQUIRE(original.c == 'x');
+        REQUIRE(original.sc == 'y');
+        REQUIRE(original.uc == 'z');
+
+        WHEN("we render it")
+        {
+            const auto rendered = to_argv("worker", original, option(&config::c, "c", "c"),
+                                          option(&config::sc, "s", "s"), option(&config::uc, "u", "u"));
+
+            THEN("each character is rendered as itself")
+            {
+                const auto expected = std::vector<std::string>{"worker", "-c", "x", "-s", "y", "-u", "z"};
+                REQUIRE(std::vector<std::string>(rendered.argv(), rendered.argv() + rendered.argc()) == expected);
+            }
+
+            THEN("parsing it yields the same config")
+            {
+                const auto [reparse_result, reparsed] = do_parse(rendered.argc(), rendered.argv());
+
+                REQUIRE(reparse_result == true);
+                REQUIRE(reparsed.c == original.c);
+                REQUIRE(reparsed.sc == original.sc);
+                REQUIRE(reparsed.uc == original.uc);
+            }
+        }
+    }
+}
+
+SCENARIO("incremental parsing")
+{
+    GIVEN("a config with options and arguments")
+    {
+        struct config
+        {
+            std::string s;
+            std::optional<int> i;
+            bool b = false;
+            std::vector<std::string> e;
+        };
+
+        incremental_parser parser(argument(&config::s, "s"), argument(&config::i, "i"), option(&config::b, "b", "b"),
+                                  option(&config::e, "e", "e"));
+
+        WHEN("we feed the tokens one at a time")
+        {
+            for(const auto token : {"-e", "e1", "string 1", "-b", "-e", "e2", "42"})
+            {
+                REQUIRE(parser.feed(token));
+            }
+
+            THEN("they are correctly parsed")
+            {
+                const auto [parse_result, config] = parser.finish();
+
+                REQUIRE(parse_result == true);
+                REQUIRE(config.s == "string 1");
+                REQUIRE(config.i == 42);
+                REQUIRE(config.b);
+                REQUIRE(config.e == std::vector<std::string>{"e1", "e2"});
+                REQUIRE(parse_result.usage_message == "<s> [<i>] [-b <b>] [-e <e>]");
+            }
+        }
+
+        WHEN("we feed an unknown option while an argument is still free")
+        {
+            REQUIRE(parser.feed("string 1"));
+
+            THEN("it is rejected straight away, as is anything after it")
+            {
+                REQUIRE(!parser.feed("-x"));
+                REQUIRE(!parser.feed("-b"));
+
+                const auto [parse_result, _] = parser.finish();
+                static_cast<void>(_);
+                REQUIRE(parse_result == false);
+            }
+        }
+
+        WHEN("we feed a negative number")
+        {
+            REQUIRE(parser.feed("string 1"));
+            REQUIRE(parser.feed("-42"));
+
+            THEN("it goes to the next argument")
+            {
+                const auto [parse_result, config] = parser.finish();
+
+                REQUIRE(parse_result == true);
+                REQUIRE(config.i == -42);
+            }
+        }
+
+        WHEN("we repeat a flag")
+        {
+            REQUIRE(parser.feed("-b"));
+
+            THEN("it is rejected")
+            {
+                REQUIRE(!parser.feed("-b"));
+            }
+        }
+
+        WHEN("an option is still waiting for its value")
+        {
+            REQUIRE(parser.feed("string 1"));
+            REQUIRE(parser.feed("-e"));
+
+            THEN("parsing fails")
+            {
+                const auto [parse_result, _] = parser.finish();
+                static_cast<void>(_);
+                REQUIRE(parse_result == false);
+            }
+        }
+
+        WHEN("a required argument is missing")
+        {
+            REQUIRE(parser.feed("-b"));
+
+            THEN("parsing fails")
+            {
+                const auto [parse_result, _] = parser.finish();
+                static_cast<void>(_);
+                REQUIRE(parse_result == false);
+            }
+        }
+    }
+}
+
+SCENARIO("line parsing")
+{
+    GIVEN("a config with options and an argument")
+    {
+        struct config
+        {
+            std::string mode;
+            int n = 0;
+            std::vector<std::string> e;
+            std::optional<std::string> s;
+        };
+
+        const auto do_parse = [](std::string_view line) {
+            return parse_line(line, option(&config::mode, "mode", "mode"), option(&config::n, "n", "n"),
+                              option(&config::e, "e", "e"), argument(&config::s, "s"));
+        };
+
+        WHEN("we provide quoted words")
+        {
+            const auto [parse_result, config] = do_parse("  -mode \"fast path\" -n 10\t-e 'it''s \"x\"' "
+                                                         "-e a\\ b\\\"c -e \"\\$HOME \\\\ \\q\" -e '' "
+                                                         "a_rather_long_unquoted_argument_to_cross_a_vector  ");
+
+            THEN("they are correctly parsed")
+            {
+                REQUIRE(parse_result == true);
+                REQUIRE(config.mode == "fast path");
+                REQUIRE(config.n == 10);
+                REQUIRE(config.e == std::vector<std::string>{"its \"x\"", "a b\"c", "$HOME \\ \\q", ""});
+                REQUIRE(config.s == "a_rather_long_unquoted_argument_to_cross_a_vector");
+            }
+        }
+
+        WHEN("a quote is not terminated")
+        {
+            const auto [parse_result, _] = do_parse("-mode \"fast path");
+            static_cast<void>(_);
+
+            THEN("parsing fails")
+            {
+                REQUIRE(parse_result == false);
+            }
+        }
+
+        WHEN("the line ends with a backslash")
+        {
+            const auto [parse_result, _] = do_parse("-mode fast\\");
+            static_cast<void>(_);
+
+            THEN("parsing fails")
+            {
+                REQUIRE(parse_result == false);
+            }
+        }
+
+        WHEN("there is an extra word")
+        {
+            const auto [parse_result, _] = do_parse("-mode fast one two");
+            static_cast<void>(_);
+
+            THEN("parsing fails")
+            {
+                REQUIRE(parse_result == false);
+            }
+        }
+    }
+}
+
+SCENARIO("parsing with a memory resource")
+{
+    GIVEN("a config with numeric options and arguments")
+    {
+        struct config
+        {
+            int n  = 0;
+            bool b = false;
+            std::optional<double> d;
+            std::vector<int> v;
+        };
+
+        const auto n = option(&config::n, "n", "an int", "a long description of an int");
+        const auto b = option(&config::b, "b", "a bool");
+        const auto d = argument(&config::d, "a double");
+        const auto v = option(&config::v, "v", "ints");
+
+        WHEN("we parse with an arena that cannot grow")
+        {
+            std::array<std::byte, 4096> buffer;
+            std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size(), std::pmr::null_memory_resource());
+
+            const std::array<const char*, 9> argv = {"program name", "-v", "1", "-n", "42", "2.5", "-b", "-v", "2"};
+            const auto [parse_result, config] = parse(&arena, static_cast<int>(argv.size()), argv.data(), n, b, v, d);
+
+            THEN("they are correctly parsed")
+            {
+                REQUIRE(static_cast<bool>(parse_result));
+                REQUIRE(config.n == 42);
+                REQUIRE(config.b);
+                REQUIRE(config.d == Approx(2.5));
+                REQUIRE(config.v == std::vector<int>{1, 2});
+            }
+
+            THEN("the parse result uses the arena")
+            {
+                REQUIRE(parse_result.usage_message == "-n <an int> [-b <a bool>] [-v <ints>] [<a double>]");
+                REQUIRE(parse_result.usage_message.get_allocator().resource() == &arena);
+                REQUIRE(parse_result.parameters_description.size() == 4);
+                REQUIRE(parse_result.parameters_description[0] == "an int: a long description of an int");
+                REQUIRE(parse_result.parameters_description[0].get_allocator().resource() == &arena);
+            }
+        }
+    }
+}
+
+namespace
+{
+    static constexpr std::array<std::string_view, 2> modes{"fast", "safe"};
+    static constexpr std::array<int, 3> sizes{1, 2, 4};
+
+    // Ordered and readable, but not printable
+    enum class level
+    {
+        low,
+        high
+    };
+
+    std::istream& operator>>(std::istream& is, level& l)
+    {
+        std::string s;
+        is >> s;
+        if(s == "low") l = level::low;
+        else if(s == "high") l = level::high;
+        else is.setstate(std::ios::failbit);
+        return is;
+    }
+} // namespace
+
+SCENARIO("constraints")
+{
+    GIVEN("a config with constrained options and arguments")
+    {
+        struct config
+        {
+            int threads = 0;
+            std::string mode;
+            std::vector<int> sizes;
+            std::optional<std::string> path;
+        };
+
+        const auto do_parse = [](auto argv) {
+            return parse(int(static_cast<int>(argv.size())), argv.data(),
+                         option(&config::threads, "t", "threads").range(1, 256),
+                         option(&config::mode, "mode", "mode").choices<modes>(),
+                         option(&config::sizes, "s", "sizes").choices<sizes>(),
+                         argument(&config::path, "path")
+                             .check([](const std::string& p) { return !p.empty() && p[0] == '/'; },
+                                    "is not an absolute path"));
+        };
+
+        WHEN("all values are acceptable")
+        {
+            const std::array<const char*, 10> argv = {"program name", "-t", "256", "-mode", "safe",
+                                                      "-s",           "4",  "-s",  "1",     "/tmp"};
+
+            THEN("they are correctly parsed")
+            {
+                const auto [parse_result, config] = do_parse(argv);
+
+                REQUIRE(parse_result == true);
+                REQUIRE(parse_result.errors.empty());
+                REQUIRE(config.threads == 256);
+                REQUIRE(config.mode == "safe");
+                REQUIRE(config.sizes == std::vector<int>{4, 1});
+                REQUIRE(config.path == "/tmp");
+            }
+        }
+
+        WHEN("a value is out of range")
+        {
+            const std::array<const char*, 5> argv = {"program name", "-t", "300", "-mode", "fast"};
+
+            THEN("parsing fails and the error is reported")
+            {
+                const auto [parse_result, _] = do_parse(argv);
+                static_cast<void>(_);
+
+                REQUIRE(parse_result == false);
+                REQUIRE(parse_result.errors == detail::svector{"-t: '300' is not in [1, 256]"});
+            }
+        }
+
+        WHEN("a value is not a valid number")
+        {
+            const std::array<const char*, 5> argv = {"program name", "-t", "12x", "-mode", "fast"};
+
+            THEN("parsing fails and the error is reported")
+            {
+                const auto [parse_result, _] = do_parse(argv);
+                static_cast<void>(_);
+
+                REQUIRE(parse_result == false);
+                REQUIRE(parse_result.errors == detail::svector{"-t: '12x' is not a valid value"});
+            }
+        }
+
+        WHEN("a value is not one of the choices")
+        {
+            const std::array<const char*, 7> argv = {"program name", "-t", "1", "-mode", "fast", "-s", "3"};
+
+            THEN("parsing fails and the error is reported")
+            {
+                const auto [parse_result, _] = do_parse(argv);
+                static_cast<void>(_);
+
+                REQUIRE(parse_result == false);
+                REQUIRE(parse_result.errors == detail::svector{"-s: '3' is not one of 1, 2, 4"});
+            }
+        }
+
+        WHEN("a value does not satisfy the predicate")
+        {
+            const std::array<const char*, 6> argv = {"program name", "-t", "1", "-mode", "fast", "tmp"};
+
+            THEN("parsing fails and the error is reported")
+            {
+                const auto [parse_result, _] = do_parse(argv);
+                static_cast<void>(_);
+
+                REQUIRE(parse_result == false);
+                REQUIRE(parse_result.errors == detail::svector{"<path>: 'tmp' is not an absolute path"});
+            }
+        }
+
+        WHEN("we parse incrementally")
+        {
+            incremental_parser parser(option(&config::mode, "mode", "mode").choices<modes>());
+
+            THEN("an unacceptable value is rejected straight away")
+            {
+                REQUIRE(parser.feed("-mode"));
+                REQUIRE(!parser.feed("slow"));
+
+                const auto [parse_result, _] = parser.finish();
+                static_cast<void>(_);
+                REQUIRE(parse_result.errors == detail::svector{"-mode: 'slow' is not one of fast, safe"});
+            }
+        }
+    }
+}
+
+SCENARIO("constraints on values that cannot be printed")
+{
+    GIVEN("an option whose type can be read but not written")
+    {
+        struct config
+        {
+            level l = level::low;
+        };
+
+        WHEN("it is parsed")
+        {
+            const std::array<const char*, 3> argv = {"program name", "-l", "high"};
+            const auto [parse_result, config] = parse(static_cast<int>(argv.size()), argv.data(),
+                                                      option(&config::l, "l", "level").range(level::low, level::low));
+
+            THEN("a range error is still reported")
+            {
+                REQUIRE(parse_result == false);
+                REQUIRE(parse_result.errors == std::vector<std::string>{"-l: 'high' is out of range"});
+            }
+        }
+    }
+}
+
+SCENARIO("multi-value option parsing")
+{
+    GIVEN("a config with fixed-arity options")
+    {
+        struct config
+        {
+            std::array<double, 4> bbox{};
+            std::pair<std::string, int> endpoint;
+            std::optional<std::tuple<int, int, int>> color;
+            std::vector<std::array<int, 2>> points;
+        };
+
+        const auto parameters = std::make_tuple(
+            option(&config::bbox, "bbox", "box"), option(&config::endpoint, "e", "endpoint"),
+            option(&config::color, "c", "color"), option(&config::points, "p", "point"));
+
+        const auto do_parse = [&](auto argv) {
+            return std::apply(
+                [&](const auto&... p) { return parse(static_cast<int>(argv.size()), argv.data(), p...); }, parameters);
+        };
+
+        WHEN("we provide all the values")
+        {
+            const std::array<const char*, 19> argv = {"program name", "-p", "1",  "2", "-bbox", "0",  "-0.5",
+                                                      "10.25",        "20", "-e", "host name", "80", "-c", "255",
+                                                      "128",          "0",  "-p", "3", "4"};
+
+            THEN("they are correctly parsed")
+            {
+                const auto [parse_result, config] = do_parse(argv);
+
+                REQUIRE(parse_result == true);
+                REQUIRE(config.bbox == std::array<double, 4>{0, -0.5, 10.25, 20});
+                REQUIRE(config.endpoint == std::pair<std::string, int>{"host name", 80});
+                REQUIRE(config.color == std::make_tuple(255, 128, 0));
+                REQUIRE(config.points == std::vector<std::array<int, 2>>{{1, 2}, {3, 4}});
+                REQUIRE(parse_result.usage_message ==
+                        "-bbox <box>{4} -e <endpoint>{2} [-c <color>{3}] [-p <point>{2}]");
+            }
+
+            THEN("rendering and parsing again yields the same config")
+            {
+                const auto [parse_result, config] = do_parse(argv);
+                REQUIRE(parse_result == true);
+
+                const auto rendered = std::apply(
+                    [&, &config = config](const auto&... p) { return to_argv("program name", config, p...); },
+                    parameters);
+                const auto [reparse_result, reparsed] = std::apply(
+                    [&](const auto&... p) { return parse(rendered.argc(), rendered.argv(), p...); }, parameters);
+
+                REQUIRE(reparse_result == true);
+                REQUIRE(reparsed.bbox == config.bbox);
+                REQUIRE(reparsed.endpoint == config.endpoint);
+                REQUIRE(reparsed.color == config.color);
+                REQUIRE(reparsed.points == config.points);
+            }
+        }
+
+        WHEN("a value is missing")
+        {
+            const std::array<const char*, 8> argv = {"program name", "-e", "host", "80", "-bbox", "0", "0", "1"};
+
+            THEN("parsing fails")
+            {
+                const auto [parse_result, _] = do_parse(argv);
+                static_cast<void>(_);
+
+                REQUIRE(parse_result == false);
+            }
+        }
+
+        WHEN("an option is repeated before its value is complete")
+        {
+            const std::array<const char*, 14> argv = {"program name", "-e", "host", "80", "-bbox", "0", "0",
+                                                      "1",            "1",  "-p",   "1",  "-p",    "3", "4"};
+
+            THEN("parsing fails")
+            {
+                const auto [parse_result, _] = do_parse(argv);
+                static_cast<void>(_);
+
+                REQUIRE(parse_result == false);
+            }
+        }
+
+        WHEN("we parse incrementally")
+        {
+            incremental_parser parser(option(&config::bbox, "bbox", "box"), option(&config::endpoint, "e", "endpoint"));
+            for(const auto token : {"-e", "host", "80", "-bbox", "1", "2", "3", "4"})
+            {
+                REQUIRE(parser.feed(token));
+            }
+
+            THEN("they are correctly parsed")
+            {
+                const auto [parse_result, config] = parser.finish();
+
+                REQUIRE(parse_result == true);
+                REQUIRE(config.bbox == std::array<double, 4>{1, 2, 3, 4});
+                REQUIRE(config.endpoint == std::pair<std::string, int>{"host", 80});
+            }
+        }
+    }
+}
@@ -0,0 +1,135 @@
+#include "bisect/bicla/preset.h"
+
+#include <array>
+#pragma warning(push)
+#pragma warning(disable : 4996)
+#include "catch2/catch.hpp"
+#pragma warning(pop)
+using namespace bisect::bicla;
+
+//------------------------------------------------------------------------------
+
+namespace
+{
+    enum class mode
+    {
+        fast,
+        safe
+    };
+
+    static constexpr std::array<std::pair<std::string_view, mode>, 2> mode_names{
+        {{"fast", mode::fast}, {"safe", mode::safe}}};
+
+    struct config
+    {
+        int threads     = 1;
+        long long limit = 0;
+        mode m          = mode::safe;
+        bool pin        = false;
+        std::string_view name;
+        int port = 0;
+    };
+
+    template <std::size_t N> constexpr auto make_preset(const std::array<std::string_view, N>& tokens)
+    {
+        return parse_preset(tokens, preset_option(&config::threads, "threads"), preset_option(&config::limit, "limit"),
+                            preset_option(&config::m, "mode", mode_names), preset_option(&config::pin, "pin"),
+                            preset_option(&config::name, "name"));
+    }
+
+    constexpr auto throughput =
+        make_preset(std::array<std::string_view, 7>{"-threads", "64", "-mode", "fast", "-pin", "-name", "throughput"});
+
+    static_assert(throughput);
+    static_assert(throughput.config.threads == 64);
+    static_assert(throughput.config.m == mode::fast);
+    static_assert(throughput.config.pin);
+    static_assert(throughput.config.name == "throughput");
+
+    static_assert(make_preset(std::array<std::string_view, 2>{"-limit", "-9223372036854775808"}).config.limit ==
+                  std::numeric_limits<long long>::min());
+    static_assert(make_preset(std::array<std::string_view, 2>{"-mode", "1"}).config.m == mode::safe);
+
+    static_assert(!make_preset(std::array<std::string_view, 2>{"-threads", "2147483648"}));
+    static_assert(!make_preset(std::array<std::string_view, 2>{"-threads", "12x"}));
+    static_assert(!make_preset(std::array<std::string_view, 2>{"-mode", "slow"}));
+    static_assert(!make_preset(std::array<std::string_view, 1>{"-threads"}));
+    static_assert(!make_preset(std::array<std::string_view, 1>{"-unknown"}));
+} // namespace
+
+SCENARIO("presets")
+{
+    GIVEN("a preset parsed at compile time")
+    {
+        WHEN("we parse a command line starting from it")
+        {
+            const std::array<const char*, 3> argv = {"program name", "-threads", "8"};
+            const auto [parse_result, c] =
+                parse(throughput, static_cast<int>(argv.size()), argv.data(),
+                      option(&config::threads, "threads", "threads"), option(&config::pin, "pin", "pin"));
+
+            THEN("the command line overrides the preset")
+            {
+                REQUIRE(static_cast<bool>(parse_result));
+                REQUIRE(c.threads == 8);
+                REQUIRE(c.pin);
+                REQUIRE(c.m == mode::fast);
+                REQUIRE(c.name == "throughput");
+            }
+        }
+
+        WHEN("the command line leaves out a required option that the preset sets")
+        {
+            const std::array<const char*, 2> argv = {"program name", "-pin"};
+            const auto [parse_result, c] =
+                parse(throughput, static_cast<int>(argv.size()), argv.data(),
+                      option(&config::threads, "threads", "threads"), option(&config::pin, "pin", "pin"));
+
+            THEN("the preset provides it")
+            {
+                REQUIRE(static_cast<bool>(parse_result));
+                REQUIRE(c.threads == 64);
+                REQUIRE(c.pin);
+            }
+        }
+
+        WHEN("the command line leaves out a required option that the preset does not set")
+        {
+            const std::array<const char*, 3> argv = {"program name", "-threads", "8"};
+            const auto [parse_result, c] = parse(throughput, static_cast<int>(argv.size()), argv.data(),
+                                                 option(&config::threads, "threads", "threads"),
+                                                 option(&config::port, "port", "port").range(1, 65535));
+
+            THEN("it is still required")
+            {
+                REQUIRE(!parse_result);
+            }
+        }
+
+        WHEN("a preset value that is kept does not satisfy the runtime constraints")
+        {
+            const std::array<const char*, 1> argv = {"program name"};
+            const auto [parse_result, c] = parse(throughput, static_cast<int>(argv.size()), argv.data(),
+                                                 option(&config::threads, "threads", "threads").range(1, 16));
+
+            THEN("it is rejected")
+            {
+                REQUIRE(!parse_result);
+                REQUIRE(parse_result.errors == std::vector<std::string>{"-threads: '64' is not in [1, 16]"});
+            }
+        }
+
+        WHEN("we parse from the configuration alone")
+        {
+            const std::array<const char*, 2> argv = {"program name", "-pin"};
+            const auto [parse_result, c] =
+                parse(throughput.config, static_cast<int>(argv.size()), argv.data(),
+                      option(&config::threads, "threads", "threads"), option(&config::pin, "pin", "pin"));
+
+            THEN("required options must be on the command line")
+            {
+                REQUIRE(!parse_result);
+            }
+        }
+    }
+}
@@ -0,0 +1,143 @@
+#include "bisect/bicla/profile.h"
+
+#include <array>
+#include <cstdio>
+#include <filesystem>
+#pragma warning(push)
+#pragma warning(disable : 4996)
+#include "catch2/catch.hpp"
+#pragma warning(pop)
+using namespace bisect::bicla;
+
+//------------------------------------------------------------------------------
+
+namespace
+{
+    struct config
+    {
+        std::string input;
+        bool verbose = false;
+        std::optional<int> threads;
+        std::optional<std::string> log;
+    };
+
+    auto parameters()
+    {
+        return std::make_tuple(argument(&config::input, "input"), option(&config::verbose, "v", "verbose"),
+                               option(&config::threads, "t", "threads"), option(&config::log, "l", "log"));
+    }
+
+    template <std::size_t N> auto parse_profiled(usage_profile& profile, const std::array<const char*, N>& argv)
+    {
+        return std::apply(
+            [&](const auto&... p) { return parse(profile, static_cast<int>(argv.size()), argv.data(), p...); },
+            parameters());
+    }
+
+    const usage_profile::entry* find(const usage_profile& profile, const std::string& parameter)
+    {
+        for(const auto& e : profile.entries())
+        {
+            if(e.parameter == parameter) return &e;
+        }
+
+        return nullptr;
+    }
+} // namespace
+
+SCENARIO("usage profiles")
+{
+    GIVEN("a profile")
+    {
+        usage_profile profile;
+
+        WHEN("we parse a few command lines with it")
+        {
+            const auto [r1, c1] = parse_profiled(profile, std::array<const char*, 4>{"program", "a.txt", "-t", "4"});
+            const auto [r2, c2] = parse_profiled(profile, std::array<const char*, 3>{"program", "in.txt", "-v"});
+
+            THEN("the results are the same as without profiling")
+            {
+                REQUIRE(static_cast<bool>(r1));
+                REQUIRE(c1.threads == 4);
+                REQUIRE(static_cast<bool>(r2));
+                REQUIRE(c2.input == "in.txt");
+                REQUIRE(c2.verbose);
+            }
+
+            THEN("each parameter has been counted")
+            {
+                REQUIRE(profile.parses() == 2);
+                REQUIRE(profile.entries().size() == 4);
+                REQUIRE(find(profile, "<input>")->hits == 2);
+                REQUIRE(find(profile, "-v")->hits == 1);
+                REQUIRE(find(profile, "-t")->hits == 1);
+                REQUIRE(find(profile, "-l")->hits == 0);
+            }
+
+            AND_WHEN("we save it and merge it into another profile")
+            {
+                const auto path = (std::filesystem::temp_directory_path() / "bicla.profile").string();
+                REQUIRE(profile.save(path));
+
+                usage_profile merged;
+                parse_profiled(merged, std::array<const char*, 3>{"program", "in.txt", "-v"});
+                const auto merge_ok = merged.merge(path);
+                std::remove(path.c_str());
+
+                THEN("the counts add up")
+                {
+                    REQUIRE(merge_ok);
+                    REQUIRE(merged.parses() == 3);
+                    REQUIRE(find(merged, "-v")->hits == 2);
+                    REQUIRE(find(merged, "-t")->hits == 1);
+                    REQUIRE(find(merged, "-v")->nanoseconds >= find(profile, "-v")->nanoseconds);
+                }
+            }
+        }
+
+        WHEN("we merge a file that is not a profile")
+        {
+            THEN("it is rejected")
+            {
+                REQUIRE(!profile.merge("bicla_missing.profile"));
+                REQUIRE(profile.parses() == 0);
+            }
+        }
+    }
+}
+
+SCENARIO("preferred options")
+{
+    GIVEN("an incremental parser that tries some options first")
+    {
+        auto parser = std::apply([](const auto&... p) { return incremental_parser(p...); }, parameters());
+        parser.prefer(std::array<std::string_view, 3>{"l", "input", "v"});
+
+        WHEN("we feed it a command line")
+        {
+            for(const auto token : {"-t", "2", "-v", "in.txt", "-l", "out.log"})
+            {
+                REQUIRE(parser.feed(token));
+            }
+            const auto [parse_result, c] = parser.finish();
+
+            THEN("it is parsed as without preferences")
+            {
+                REQUIRE(static_cast<bool>(parse_result));
+                REQUIRE(c.input == "in.txt");
+                REQUIRE(c.threads == 2);
+                REQUIRE(c.verbose);
+                REQUIRE(c.log == "out.log");
+            }
+        }
+
+        WHEN("we feed it an unknown option")
+        {
+            THEN("it is rejected")
+            {
+                REQUIRE(!parser.feed("-x"));
+            }
+        }
+    }
+}
@@ -0,0 +1,104 @@
+#include "bisect/bicla/reload.h"
+
+#include <array>
+#pragma warning(push)
+#pragma warning(disable : 4996)
+#include "catch2/catch.hpp"
+#pragma warning(pop)
+using namespace bisect::bicla;
+
+//------------------------------------------------------------------------------
+
+SCENARIO("configuration diff")
+{
+    GIVEN("two configurations")
+    {
+        struct config
+        {
+            std::string s;
+            int i = 0;
+            std::optional<float> f;
+        };
+
+        const config before{"a", 1, std::nullopt};
+        const config after{"a", 2, 3.0f};
+
+        WHEN("we compare them")
+        {
+            const auto changed = diff(before, after, option(&config::s, "s", "a string"),
+                                      option(&config::i, "i", "an int"), option(&config::f, "f", "a float"));
+
+            THEN("only the parameters whose values differ are reported")
+            {
+                REQUIRE(changed == std::vector<bool>{false, true, true});
+            }
+        }
+    }
+}
+
+SCENARIO("configuration reload")
+{
+    GIVEN("a snapshot holding a parsed configuration")
+    {
+        struct config
+        {
+            std::string mode;
+            int threads = 0;
+        };
+
+        const auto do_reload = [](config_snapshot<config>& snapshot, auto argv) {
+            return snapshot.reload(static_cast<int>(argv.size()), argv.data(), option(&config::mode, "m", "mode"),
+                                   option(&config::threads, "t", "threads"));
+        };
+
+        config_snapshot<config> snapshot;
+        const std::array<const char*, 5> initial = {"program name", "-m", "fast", "-t", "4"};
+        REQUIRE(do_reload(snapshot, initial));
+
+        const auto first = snapshot.load();
+        REQUIRE(first->mode == "fast");
+        REQUIRE(first->threads == 4);
+
+        WHEN("we reload with one different value")
+        {
+            const std::array<const char*, 5> argv = {"program name", "-m", "fast", "-t", "8"};
+            const auto result                     = do_reload(snapshot, argv);
+
+            THEN("only that parameter is reported as changed and a new snapshot is published")
+            {
+                REQUIRE(result);
+                REQUIRE(result.changed == std::vector<bool>{false, true});
+
+                const auto second = snapshot.load();
+                REQUIRE(second != first);
+                REQUIRE(second->threads == 8);
+                REQUIRE(first->threads == 4);
+            }
+        }
+
+        WHEN("we reload with the same values")
+        {
+            const auto result = do_reload(snapshot, initial);
+
+            THEN("nothing is reported as changed and the snapshot is kept")
+            {
+                REQUIRE(result);
+                REQUIRE(!result.any_changed());
+                REQUIRE(snapshot.load() == first);
+            }
+        }
+
+        WHEN("we reload with invalid arguments")
+        {
+            const std::array<const char*, 4> argv = {"program name", "-m", "safe", "extra"};
+            const auto result                     = do_reload(snapshot, argv);
+
+            THEN("parsing fails and the previous snapshot is kept")
+            {
+                REQUIRE(!result);
+                REQUIRE(!result.any_changed());
+                REQUIRE(snapshot.load() == first);
+            }
+        }
+    }
+}